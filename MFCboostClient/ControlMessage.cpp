@@ -0,0 +1,87 @@
+// 서버와 함께 빌드하므로 미리 컴파일된 헤더를 사용하지 않음
+#include "ControlMessage.h"
+
+// 생성자
+ControlView::ControlView() : data_(nullptr) {}
+
+// 프레임 본문 검사
+bool ControlView::parse(const char* data, size_t size) {
+
+    using namespace ControlSchema;
+
+    if (size < HEADER_SIZE || static_cast<uint8_t>(data[1]) != VERSION) {
+        return false;
+    }
+
+    bool valid = false;
+    switch (static_cast<ControlType>(data[0])) {
+
+    case ControlType::Heartbeat:
+        valid = size >= Heartbeat::SIZE;
+        break;
+
+    case ControlType::HeartbeatAck:
+        valid = size >= HeartbeatAck::SIZE;
+        break;
+
+    case ControlType::NetworkQuality:
+        valid = size >= NetworkQuality::SIZE;
+        break;
+
+    case ControlType::FileStart:
+        valid = FileStart::FileName::fits(data, size);
+        break;
+
+    case ControlType::FileEnd:
+        valid = FileEnd::FileName::fits(data, size);
+        break;
+    }
+
+    if (valid) {
+        data_ = data;
+    }
+    return valid;
+}
+
+// JSON 메시지로 변환
+Json::Value ControlMessage::toJson(const ControlView& view) {
+
+    using namespace ControlSchema;
+
+    Json::Value message;
+
+    switch (view.type()) {
+
+    case ControlType::Heartbeat:
+        message["type"] = "heartbeat";
+        break;
+
+    case ControlType::HeartbeatAck:
+        message["type"] = "heartbeat_ack";
+        break;
+
+    case ControlType::NetworkQuality:
+        message["type"] = "network_quality";
+        message["content"] = view.get<NetworkQuality::Quality>();
+        break;
+
+    case ControlType::FileStart:
+        message["type"] = "file_start";
+        message["content"]["transfer_id"] = view.get<FileStart::TransferId>();
+        message["content"]["filename"] = view.get<FileStart::FileName>().to_string();
+        message["content"]["filesize"] = static_cast<Json::UInt64>(view.get<FileStart::FileSize>());
+        message["content"]["offset"] = static_cast<Json::UInt64>(view.get<FileStart::Offset>());
+        break;
+
+    case ControlType::FileEnd:
+        message["type"] = "file_end";
+        message["content"]["transfer_id"] = view.get<FileEnd::TransferId>();
+        message["content"]["filename"] = view.get<FileEnd::FileName>().to_string();
+        if (view.get<FileEnd::HasCrc>()) {
+            message["content"]["crc"] = view.get<FileEnd::Crc>();
+        }
+        break;
+    }
+
+    return message;
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <boost/endian/conversion.hpp>
+#include <boost/utility/string_view.hpp>
+#include <json/json.h>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+// 제어 메시지 종류
+enum class ControlType : uint8_t {
+    Heartbeat = 1,
+    HeartbeatAck = 2,
+    NetworkQuality = 3,
+    FileStart = 4,
+    FileEnd = 5
+};
+
+// 제어 메시지 바이너리 형식 (FrameCodec::CONTROL_FLAG 프레임 본문, 클라이언트와 C++ 서버가 함께 사용)
+//   [종류 1바이트][버전 1바이트][예약 2바이트][고정 위치 필드 (big endian)][문자열 필드 (길이 2바이트 + 바이트열)]
+// 필드 위치는 아래 타입에 컴파일 시간에 고정되고, 받는 쪽은 프레임 버퍼에서 바로 읽음
+namespace ControlSchema {
+
+    const size_t HEADER_SIZE = 4;
+    const uint8_t VERSION = 1;
+
+    // 고정 위치 정수 필드
+    template <typename T, size_t Offset>
+    struct Field {
+        typedef T value_type;
+        static const size_t END = Offset + sizeof(T);
+
+        static T read(const char* base) {
+            T value;
+            memcpy(&value, base + Offset, sizeof(T));
+            return boost::endian::big_to_native(value);
+        }
+
+        static void write(char* base, T value) {
+            value = boost::endian::native_to_big(value);
+            memcpy(base + Offset, &value, sizeof(T));
+        }
+    };
+
+    // 고정 위치 실수 필드 (IEEE 754 비트를 64비트 정수로 기록)
+    template <size_t Offset>
+    struct DoubleField {
+        typedef double value_type;
+        static const size_t END = Offset + sizeof(uint64_t);
+
+        static double read(const char* base) {
+            uint64_t bits = Field<uint64_t, Offset>::read(base);
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        static void write(char* base, double value) {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            Field<uint64_t, Offset>::write(base, bits);
+        }
+    };
+
+    // 문자열 필드 (메시지 끝에 하나만 둠, 읽을 때 복사하지 않음)
+    template <size_t Offset>
+    struct StringField {
+        typedef boost::string_view value_type;
+        static const size_t END = Offset + sizeof(uint16_t); // 빈 문자열일 때의 끝
+        static const size_t MAX_LENGTH = 0xFFFF;
+
+        static boost::string_view read(const char* base) {
+            return boost::string_view(base + END, Field<uint16_t, Offset>::read(base));
+        }
+
+        static void write(char* base, const std::string& value) {
+            Field<uint16_t, Offset>::write(base, static_cast<uint16_t>(value.size()));
+            memcpy(base + END, value.data(), value.size());
+        }
+
+        // 길이가 본문 안에 들어가는지
+        static bool fits(const char* base, size_t size) {
+            return size >= END && size - END >= Field<uint16_t, Offset>::read(base);
+        }
+    };
+
+    struct Heartbeat {
+        static const ControlType TYPE = ControlType::Heartbeat;
+        static const size_t SIZE = HEADER_SIZE;
+    };
+
+    struct HeartbeatAck {
+        static const ControlType TYPE = ControlType::HeartbeatAck;
+        static const size_t SIZE = HEADER_SIZE;
+    };
+
+    struct NetworkQuality {
+        static const ControlType TYPE = ControlType::NetworkQuality;
+        typedef DoubleField<4> Quality;
+        static const size_t SIZE = Quality::END;
+    };
+
+    struct FileStart {
+        static const ControlType TYPE = ControlType::FileStart;
+        typedef Field<uint32_t, 4> TransferId;
+        typedef Field<uint64_t, 8> FileSize;
+        typedef Field<uint64_t, 16> Offset;
+        typedef StringField<24> FileName;
+        static const size_t SIZE = FileName::END;
+    };
+
+    struct FileEnd {
+        static const ControlType TYPE = ControlType::FileEnd;
+        typedef Field<uint32_t, 4> TransferId;
+        typedef Field<uint32_t, 8> Crc;
+        typedef Field<uint8_t, 12> HasCrc; // CRC 정보가 없는 서버의 file_end 를 옮긴 경우 0
+        typedef StringField<14> FileName;
+        static const size_t SIZE = FileName::END;
+    };
+}
+
+// 받은 제어 메시지 (프레임 버퍼를 가리킬 뿐 복사하지 않음, 버퍼가 살아 있는 동안만 사용)
+class ControlView {
+public:
+    ControlView();
+
+    // 프레임 본문 검사 (버전, 종류별 크기, 문자열 범위)
+    bool parse(const char* data, size_t size);
+
+    ControlType type() const {
+        return static_cast<ControlType>(data_[0]);
+    }
+
+    // 필드 읽기 (예: view.get<ControlSchema::FileStart::FileSize>())
+    template <typename F>
+    typename F::value_type get() const {
+        return F::read(data_);
+    }
+
+private:
+    const char* data_;
+};
+
+// 제어 메시지 인코딩, JSON 변환 (협상하지 않은 연결과 디버깅용)
+class ControlMessage {
+public:
+    // 메시지 인코딩 (Buffer 는 std::string 또는 std::vector<char>)
+    template <typename Buffer>
+    static void encodeHeartbeat(Buffer& out) {
+        start<ControlSchema::Heartbeat>(0, out);
+    }
+
+    template <typename Buffer>
+    static void encodeHeartbeatAck(Buffer& out) {
+        start<ControlSchema::HeartbeatAck>(0, out);
+    }
+
+    template <typename Buffer>
+    static void encodeNetworkQuality(double quality, Buffer& out) {
+        typedef ControlSchema::NetworkQuality Message;
+        char* base = start<Message>(0, out);
+        Message::Quality::write(base, quality);
+    }
+
+    template <typename Buffer>
+    static void encodeFileStart(uint32_t transferId, const std::string& fileName, uint64_t fileSize, uint64_t offset, Buffer& out) {
+        typedef ControlSchema::FileStart Message;
+        char* base = start<Message>(fileName.size(), out);
+        Message::TransferId::write(base, transferId);
+        Message::FileSize::write(base, fileSize);
+        Message::Offset::write(base, offset);
+        Message::FileName::write(base, fileName);
+    }
+
+    template <typename Buffer>
+    static void encodeFileEnd(uint32_t transferId, const std::string& fileName, uint32_t crc, bool hasCrc, Buffer& out) {
+        typedef ControlSchema::FileEnd Message;
+        char* base = start<Message>(fileName.size(), out);
+        Message::TransferId::write(base, transferId);
+        Message::Crc::write(base, crc);
+        Message::HasCrc::write(base, hasCrc ? 1 : 0);
+        Message::FileName::write(base, fileName);
+    }
+
+    // 바이너리 형식이 있는 JSON 메시지를 인코딩 (없는 종류거나 이름이 너무 길면 false)
+    template <typename Buffer>
+    static bool fromJson(const Json::Value& message, Buffer& out);
+
+    // JSON 메시지로 변환
+    static Json::Value toJson(const ControlView& view);
+
+private:
+    // 헤더를 쓰고 본문 시작 위치 반환
+    template <typename Message, typename Buffer>
+    static char* start(size_t stringLength, Buffer& out) {
+        out.resize(Message::SIZE + stringLength);
+        char* base = &out[0];
+        base[0] = static_cast<char>(Message::TYPE);
+        base[1] = static_cast<char>(ControlSchema::VERSION);
+        base[2] = 0;
+        base[3] = 0;
+        return base;
+    }
+};
+
+// 바이너리 형식이 있는 JSON 메시지를 인코딩
+template <typename Buffer>
+bool ControlMessage::fromJson(const Json::Value& message, Buffer& out) {
+
+    std::string type = message["type"].asString();
+    const Json::Value& content = message["content"];
+
+    if (type == "heartbeat") {
+        encodeHeartbeat(out);
+        return true;
+    }
+    if (type == "heartbeat_ack") {
+        encodeHeartbeatAck(out);
+        return true;
+    }
+    if (type == "network_quality" && content.isNumeric()) {
+        encodeNetworkQuality(content.asDouble(), out);
+        return true;
+    }
+
+    if ((type != "file_start" && type != "file_end") || !content.isObject()) {
+        return false;
+    }
+
+    std::string fileName = content["filename"].asString();
+    if (fileName.size() > ControlSchema::FileStart::FileName::MAX_LENGTH) {
+        return false;
+    }
+
+    uint32_t transferId = content.get("transfer_id", 0).asUInt();
+    if (type == "file_start") {
+        encodeFileStart(transferId, fileName, content["filesize"].asUInt64(), content.get("offset", 0).asUInt64(), out);
+    }
+    else {
+        encodeFileEnd(transferId, fileName, content.get("crc", 0).asUInt(), content.isMember("crc"), out);
+    }
+    return true;
+}
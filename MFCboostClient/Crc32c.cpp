@@ -0,0 +1,204 @@
+// 서버와 함께 빌드하므로 미리 컴파일된 헤더를 사용하지 않음
+#include "Crc32c.h"
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CRC32C_X64
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || (defined(__aarch64__) && defined(__ARM_FEATURE_CRC32))
+#define CRC32C_ARM64
+#if defined(_MSC_VER)
+#include <arm64intr.h>
+#else
+#include <arm_acle.h>
+#endif
+#endif
+
+#if defined(CRC32C_X64) && !defined(_MSC_VER)
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#else
+#define CRC32C_TARGET
+#endif
+
+namespace {
+
+    // Castagnoli 다항식 (반전)
+    const uint32_t CASTAGNOLI_POLY = 0x82F63B78;
+
+    // 바이트 단위 테이블 생성
+    std::array<uint32_t, 256> makeTable() {
+
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & 1) ? (crc >> 1) ^ CASTAGNOLI_POLY : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    // 테이블 방식 (CRC32C 명령어가 없는 CPU)
+    uint32_t updateSoftware(uint32_t crc, const unsigned char* data, size_t length) {
+
+        static const std::array<uint32_t, 256> table = makeTable();
+
+        for (size_t i = 0; i < length; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#if defined(CRC32C_X64)
+    // SSE4.2 지원 여부
+    bool detectHardware() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#else
+        return __builtin_cpu_supports("sse4.2");
+#endif
+    }
+
+    // SSE4.2 crc32 명령어 (8바이트씩)
+    CRC32C_TARGET uint32_t updateHardware(uint32_t crc, const unsigned char* data, size_t length) {
+
+        uint64_t crc64 = crc;
+        while (length >= sizeof(uint64_t)) {
+            uint64_t value;
+            std::memcpy(&value, data, sizeof(value));
+            crc64 = _mm_crc32_u64(crc64, value);
+            data += sizeof(value);
+            length -= sizeof(value);
+        }
+
+        crc = static_cast<uint32_t>(crc64);
+        while (length-- > 0) {
+            crc = _mm_crc32_u8(crc, *data++);
+        }
+        return crc;
+    }
+#elif defined(CRC32C_ARM64)
+    // ARMv8 CRC 확장은 ARM64 에서 항상 사용
+    bool detectHardware() {
+        return true;
+    }
+
+    // ARMv8 crc32c 명령어 (8바이트씩)
+    uint32_t updateHardware(uint32_t crc, const unsigned char* data, size_t length) {
+
+        while (length >= sizeof(uint64_t)) {
+            uint64_t value;
+            std::memcpy(&value, data, sizeof(value));
+            crc = __crc32cd(crc, value);
+            data += sizeof(value);
+            length -= sizeof(value);
+        }
+
+        while (length-- > 0) {
+            crc = __crc32cb(crc, *data++);
+        }
+        return crc;
+    }
+#else
+    bool detectHardware() {
+        return false;
+    }
+
+    uint32_t updateHardware(uint32_t crc, const unsigned char* data, size_t length) {
+        return updateSoftware(crc, data, length);
+    }
+#endif
+
+    // GF(2) 행렬 x 벡터
+    uint32_t gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+
+        uint32_t sum = 0;
+        while (vec) {
+            if (vec & 1) {
+                sum ^= *mat;
+            }
+            vec >>= 1;
+            mat++;
+        }
+        return sum;
+    }
+
+    // GF(2) 행렬 제곱
+    void gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+
+        for (int n = 0; n < 32; n++) {
+            square[n] = gf2MatrixTimes(mat, mat[n]);
+        }
+    }
+}
+
+// CPU 의 CRC32C 명령어 사용 여부
+bool Crc32c::isHardwareAccelerated() {
+
+    static const bool hardware = detectHardware();
+    return hardware;
+}
+
+// CRC32C 누적 계산
+uint32_t Crc32c::update(uint32_t crc, const char* data, size_t length) {
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    crc = ~crc;
+    if (isHardwareAccelerated()) {
+        crc = updateHardware(crc, bytes, length);
+    }
+    else {
+        crc = updateSoftware(crc, bytes, length);
+    }
+    return ~crc;
+}
+
+// 두 구간의 CRC 합치기 (zlib 의 crc32_combine 과 같은 방식)
+uint32_t Crc32c::combine(uint32_t crc1, uint32_t crc2, size_t length2) {
+
+    if (length2 == 0) {
+        return crc1;
+    }
+
+    uint32_t even[32]; // 2^(2n) 개의 0 비트를 처리하는 행렬
+    uint32_t odd[32]; // 2^(2n+1) 개의 0 비트를 처리하는 행렬
+
+    // 0 비트 하나를 처리하는 행렬
+    odd[0] = CASTAGNOLI_POLY;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; n++) {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    gf2MatrixSquare(even, odd); // 0 비트 2개
+    gf2MatrixSquare(odd, even); // 0 비트 4개
+
+    // crc1 뒤에 length2 바이트만큼 0 을 붙인 효과
+    do {
+        gf2MatrixSquare(even, odd);
+        if (length2 & 1) {
+            crc1 = gf2MatrixTimes(even, crc1);
+        }
+        length2 >>= 1;
+        if (length2 == 0) {
+            break;
+        }
+
+        gf2MatrixSquare(odd, even);
+        if (length2 & 1) {
+            crc1 = gf2MatrixTimes(odd, crc1);
+        }
+        length2 >>= 1;
+    } while (length2 != 0);
+
+    return crc1 ^ crc2;
+}
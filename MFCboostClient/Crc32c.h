@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+class Crc32c {
+public:
+    // CRC32C(Castagnoli) 누적 계산 (처음에는 crc 를 0 으로 시작)
+    static uint32_t update(uint32_t crc, const char* data, size_t length);
+
+    // 두 구간의 CRC 합치기: crc(A + B) = combine(crc(A), crc(B), B 의 길이)
+    static uint32_t combine(uint32_t crc1, uint32_t crc2, size_t length2);
+
+    // CPU 의 CRC32C 명령어 사용 여부
+    static bool isHardwareAccelerated();
+};
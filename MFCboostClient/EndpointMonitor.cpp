@@ -0,0 +1,313 @@
+#include "pch.h"
+#include "EndpointMonitor.h"
+#include "FrameCodec.h"
+#include "ShmChannel.h"
+
+namespace {
+    const std::string TLS_SCHEME = "tls://";
+    const std::string SHM_SCHEME = "shm://";
+    const size_t MAX_RESPONSE_SIZE = 64 * 1024; // heartbeat_ack 외의 큰 프레임이 오면 실패로 처리
+}
+
+const double EndpointMonitor::SMOOTHING = 0.3;
+
+// 생성자
+EndpointMonitor::Probe::Probe(boost::asio::io_context& io_context, const ServerEndpoint& endpoint)
+    : endpoint(endpoint),
+    address(endpoint.host),
+    tls(endpoint.host.compare(0, TLS_SCHEME.size(), TLS_SCHEME) == 0),
+    shm(endpoint.host.compare(0, SHM_SCHEME.size(), SHM_SCHEME) == 0),
+    resolver(io_context),
+    socket(io_context),
+    deadline(io_context),
+    header(0),
+    heartbeat("{\"type\":\"heartbeat\"}"),
+    active(false),
+    rtt_ms(-1),
+    failures(0) {
+
+    if (tls) {
+        address = address.substr(TLS_SCHEME.size());
+    }
+    else if (shm) {
+        address = address.substr(SHM_SCHEME.size());
+    }
+}
+
+// 생성자
+std::shared_ptr<EndpointMonitor> EndpointMonitor::create(boost::asio::io_context& io_context, const std::vector<ServerEndpoint>& endpoints) {
+    return std::shared_ptr<EndpointMonitor>(new EndpointMonitor(io_context, endpoints));
+}
+
+// 생성자
+EndpointMonitor::EndpointMonitor(boost::asio::io_context& io_context, const std::vector<ServerEndpoint>& endpoints)
+    : io_context_(io_context), round_timer_(io_context), pending_(0), stopped_(false) {
+
+    for (const ServerEndpoint& endpoint : endpoints) {
+        probes_.emplace_back(new Probe(io_context, endpoint));
+    }
+}
+
+// 프로브 시작
+void EndpointMonitor::start() {
+
+    auto self(shared_from_this());
+    boost::asio::post(io_context_, [this, self]() {
+        startRound();
+        });
+}
+
+// 프로브 중지 (UI 스레드에서 호출해도 되도록 io 스레드에서 정리)
+void EndpointMonitor::stop() {
+
+    auto self(shared_from_this());
+    boost::asio::post(io_context_, [this, self]() {
+
+        stopped_ = true;
+        on_round_ = nullptr;
+        round_timer_.cancel();
+
+        for (auto& probe : probes_) {
+            boost::system::error_code ec;
+            probe->active = false;
+            probe->deadline.cancel();
+            probe->resolver.cancel();
+            probe->socket.close(ec);
+        }
+        });
+}
+
+// 라운드 완료 리스너 설정
+void EndpointMonitor::setOnRoundListener(std::function<void()> listener) {
+    on_round_ = listener;
+}
+
+// 왕복 시간이 가장 짧은 정상 서버
+int EndpointMonitor::selectBest(int exclude) const {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int best = -1;
+    for (size_t i = 0; i < probes_.size(); ++i) {
+
+        const Probe& probe = *probes_[i];
+        if (static_cast<int>(i) == exclude || probe.failures > 0 || probe.rtt_ms < 0) {
+            continue;
+        }
+        if (best < 0 || probe.rtt_ms < probes_[best]->rtt_ms) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+// 프로브 밖에서 실패한 서버 표시
+void EndpointMonitor::markFailed(size_t index) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    probes_[index]->failures++;
+}
+
+// 서버 상태 목록
+std::vector<EndpointHealth> EndpointMonitor::getHealth() const {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<EndpointHealth> health;
+    for (const auto& probe : probes_) {
+        EndpointHealth entry;
+        entry.endpoint = probe->endpoint;
+        entry.healthy = probe->failures == 0 && probe->rtt_ms >= 0;
+        entry.rttMs = probe->rtt_ms;
+        entry.failures = probe->failures;
+        health.push_back(entry);
+    }
+    return health;
+}
+
+const ServerEndpoint& EndpointMonitor::getEndpoint(size_t index) const {
+    return probes_[index]->endpoint;
+}
+
+size_t EndpointMonitor::size() const {
+    return probes_.size();
+}
+
+// 모든 서버 프로브 시작
+void EndpointMonitor::startRound() {
+
+    if (stopped_ || probes_.empty()) {
+        return;
+    }
+
+    pending_ = probes_.size();
+
+    for (size_t i = 0; i < probes_.size(); ++i) {
+
+        Probe& probe = *probes_[i];
+        probe.active = true;
+
+        // 응답이 늦으면 연결을 닫아 진행 중인 작업을 끝내고 실패로 처리
+        auto self(shared_from_this());
+        probe.deadline.expires_after(std::chrono::milliseconds(PROBE_TIMEOUT_MS));
+        probe.deadline.async_wait([this, self, i](const boost::system::error_code& ec) {
+            if (!ec) {
+                finishProbe(i, false, 0);
+            }
+            });
+
+        connectProbe(i);
+    }
+}
+
+// 프로브 연결
+void EndpointMonitor::connectProbe(size_t index) {
+
+    Probe& probe = *probes_[index];
+
+    // 공유 메모리 서버는 네트워크를 거치지 않으므로 서버 프로세스가 연결을 받고 있는지만 확인
+    if (probe.shm) {
+        probe.sent = Clock::now();
+        bool listening = ShmChannel::listenerExists(probe.address);
+        finishProbe(index, listening, std::chrono::duration<double, std::milli>(Clock::now() - probe.sent).count());
+        return;
+    }
+
+    if (probe.socket.is_open() && !probe.tls) {
+        sendHeartbeat(index);
+        return;
+    }
+
+    probe.sent = Clock::now();
+
+    auto self(shared_from_this());
+    probe.resolver.async_resolve(probe.address, std::to_string(probe.endpoint.port),
+        [this, self, index](const boost::system::error_code& ec, const boost::asio::ip::tcp::resolver::results_type& results) {
+
+            if (ec || !probes_[index]->active) {
+                finishProbe(index, false, 0);
+                return;
+            }
+
+            Probe& probe = *probes_[index];
+            boost::asio::async_connect(probe.socket, results,
+                [this, self, index](const boost::system::error_code& ec, const boost::asio::ip::tcp::endpoint&) {
+
+                    Probe& probe = *probes_[index];
+                    if (ec || !probe.active) {
+                        finishProbe(index, false, 0);
+                        return;
+                    }
+
+                    // TLS 서버는 핸드셰이크 없이 TCP 연결 시간만 잼
+                    if (probe.tls) {
+                        double rtt_ms = std::chrono::duration<double, std::milli>(Clock::now() - probe.sent).count();
+                        boost::system::error_code close_ec;
+                        probe.socket.close(close_ec);
+                        finishProbe(index, true, rtt_ms);
+                        return;
+                    }
+
+                    boost::system::error_code option_ec;
+                    probe.socket.set_option(boost::asio::ip::tcp::no_delay(true), option_ec);
+                    sendHeartbeat(index);
+                });
+        });
+}
+
+// heartbeat 전송 후 응답 대기
+void EndpointMonitor::sendHeartbeat(size_t index) {
+
+    Probe& probe = *probes_[index];
+    probe.header = FrameCodec::encodeHeader(probe.heartbeat.size(), 0);
+    probe.sent = Clock::now();
+
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(&probe.header, sizeof(uint32_t)));
+    buffers.push_back(boost::asio::buffer(probe.heartbeat));
+
+    auto self(shared_from_this());
+    boost::asio::async_write(probe.socket, buffers,
+        [this, self, index](const boost::system::error_code& ec, std::size_t) {
+
+            Probe& probe = *probes_[index];
+            if (ec || !probe.active) {
+                finishProbe(index, false, 0);
+                return;
+            }
+
+            boost::asio::async_read(probe.socket, boost::asio::buffer(&probe.header, sizeof(uint32_t)),
+                [this, self, index](const boost::system::error_code& ec, std::size_t) {
+
+                    Probe& probe = *probes_[index];
+                    size_t length = 0;
+                    uint32_t flags = 0;
+                    if (!ec) {
+                        FrameCodec::decodeHeader(probe.header, length, flags);
+                    }
+                    if (ec || !probe.active || length > MAX_RESPONSE_SIZE) {
+                        finishProbe(index, false, 0);
+                        return;
+                    }
+
+                    probe.response.resize(length);
+                    boost::asio::async_read(probe.socket, boost::asio::buffer(probe.response),
+                        [this, self, index](const boost::system::error_code& ec, std::size_t) {
+
+                            Probe& probe = *probes_[index];
+                            if (ec || !probe.active) {
+                                finishProbe(index, false, 0);
+                                return;
+                            }
+
+                            // 프로브 연결에는 heartbeat 만 보내므로 어떤 응답이든 heartbeat_ack
+                            finishProbe(index, true, std::chrono::duration<double, std::milli>(Clock::now() - probe.sent).count());
+                        });
+                });
+        });
+}
+
+// 프로브 하나 끝
+void EndpointMonitor::finishProbe(size_t index, bool success, double rtt_ms) {
+
+    Probe& probe = *probes_[index];
+    if (!probe.active) {
+        return; // 이미 끝난 프로브 (시간 초과 후 닫은 연결의 완료 등)
+    }
+
+    probe.active = false;
+    probe.deadline.cancel();
+
+    if (!success) {
+        boost::system::error_code ec;
+        probe.resolver.cancel();
+        probe.socket.close(ec);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (success) {
+            probe.rtt_ms = probe.rtt_ms < 0 ? rtt_ms : SMOOTHING * rtt_ms + (1 - SMOOTHING) * probe.rtt_ms;
+            probe.failures = 0;
+        }
+        else {
+            probe.failures++;
+        }
+    }
+
+    if (--pending_ > 0 || stopped_) {
+        return;
+    }
+
+    if (on_round_) {
+        on_round_();
+    }
+
+    auto self(shared_from_this());
+    round_timer_.expires_after(std::chrono::milliseconds(PROBE_INTERVAL_MS));
+    round_timer_.async_wait([this, self](const boost::system::error_code& ec) {
+        if (!ec) {
+            startRound();
+        }
+        });
+}
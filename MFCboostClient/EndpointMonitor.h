@@ -0,0 +1,106 @@
+#pragma once
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 서버 주소
+struct ServerEndpoint {
+    std::string host; // "tls://" 로 시작하면 TLS, "shm://이름" 이면 같은 컴퓨터의 공유 메모리 (포트 사용 안 함)
+    int port;
+};
+
+// 서버 하나의 상태
+struct EndpointHealth {
+    ServerEndpoint endpoint;
+    bool healthy; // 마지막 프로브가 성공했는지
+    double rttMs; // 지수 이동 평균 왕복 시간 (아직 모르면 -1)
+    int failures; // 연속 실패 횟수
+};
+
+// 여러 서버의 왕복 시간과 상태를 백그라운드에서 측정 (io 스레드에서 동작, getHealth 는 어느 스레드에서 호출해도 됨)
+// 일반 서버는 프로브 연결을 하나씩 유지하며 heartbeat 왕복 시간을 재고, TLS 서버는 TCP 연결 시간만 잼
+// 공유 메모리 서버는 연결 요청 대기열이 살아 있는지만 확인 (왕복 시간은 확인에 걸린 시간)
+// 모든 서버를 동시에 프로브하고 한 라운드가 끝날 때마다 리스너 호출
+class EndpointMonitor : public std::enable_shared_from_this<EndpointMonitor> {
+public:
+    // 생성자
+    static std::shared_ptr<EndpointMonitor> create(boost::asio::io_context& io_context, const std::vector<ServerEndpoint>& endpoints);
+
+    // 프로브 시작 (첫 라운드는 바로, 이후 PROBE_INTERVAL_MS 마다)
+    void start();
+
+    // 프로브 중지 (프로브 연결을 닫음)
+    void stop();
+
+    // 라운드 완료 리스너 설정 (io 스레드에서 호출)
+    void setOnRoundListener(std::function<void()> listener);
+
+    // 왕복 시간이 가장 짧은 정상 서버 (exclude 는 제외, 없으면 -1)
+    int selectBest(int exclude = -1) const;
+
+    // 프로브 밖에서 실패한 서버 표시 (다음 프로브가 성공할 때까지 selectBest 에서 제외)
+    void markFailed(size_t index);
+
+    // 서버 상태 목록 (생성할 때 받은 순서)
+    std::vector<EndpointHealth> getHealth() const;
+
+    const ServerEndpoint& getEndpoint(size_t index) const;
+
+    size_t size() const;
+
+    static const int PROBE_INTERVAL_MS = 2000;
+    static const int PROBE_TIMEOUT_MS = 1500; // 이 안에 응답이 없으면 실패
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // 서버 하나의 프로브 상태
+    struct Probe {
+        Probe(boost::asio::io_context& io_context, const ServerEndpoint& endpoint);
+
+        ServerEndpoint endpoint;
+        std::string address; // "tls://", "shm://" 를 뗀 주소
+        bool tls;
+        bool shm;
+        boost::asio::ip::tcp::resolver resolver;
+        boost::asio::ip::tcp::socket socket; // TLS 서버는 연결 시간만 재고 닫음
+        boost::asio::steady_timer deadline;
+        uint32_t header; // 보낼 때는 heartbeat 프레임 헤더, 받을 때는 응답 헤더
+        std::string heartbeat; // heartbeat 프레임 본문
+        std::vector<char> response;
+        Clock::time_point sent; // 측정 시작 시각
+        bool active; // 이번 라운드를 진행 중인지
+        double rtt_ms;
+        int failures;
+    };
+
+    // 생성자 (private)
+    EndpointMonitor(boost::asio::io_context& io_context, const std::vector<ServerEndpoint>& endpoints);
+
+    // 모든 서버 프로브 시작
+    void startRound();
+
+    // 프로브 연결 (닫혀 있을 때만)
+    void connectProbe(size_t index);
+
+    // heartbeat 전송 후 응답 대기
+    void sendHeartbeat(size_t index);
+
+    // 프로브 하나 끝 (성공하면 왕복 시간 반영)
+    void finishProbe(size_t index, bool success, double rtt_ms);
+
+    boost::asio::io_context& io_context_;
+    std::vector<std::unique_ptr<Probe>> probes_;
+    boost::asio::steady_timer round_timer_;
+    size_t pending_; // 이번 라운드에서 끝나지 않은 프로브 수
+    bool stopped_;
+    std::function<void()> on_round_;
+    mutable std::mutex mutex_; // probes_ 의 rtt_ms, failures 보호 (getHealth)
+
+    static const double SMOOTHING; // 지수 이동 평균 가중치
+};
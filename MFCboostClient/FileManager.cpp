@@ -1,123 +1,660 @@
 #include "pch.h"
 #include "FileManager.h"
+#include "Crc32c.h"
+#include "Profiler.h"
+#include <array>
 #include <fstream>
+#include <set>
 #include <boost/filesystem.hpp>
 #include <Windows.h>
 #include <ShlObj.h>
 #include <stdexcept>
 
-//  ޽
+// 디버깅 메시지
 void OutputDebugStringIfNeeded(const std::string& message) {
     OutputDebugStringA(message.c_str());
 }
 
-// 
-FileManager::FileManager() : total_file_size_(0), received_size_(0) {}
+const char* const FileManager::PART_EXTENSION = ".part";
+const char* const FileManager::PART_INFO_EXTENSION = ".partinfo";
 
-//  ٿε 
-void FileManager::startFileDownload(const std::string& fileName, size_t fileSize) {
+// 생성자
+FileManager::FileManager() {}
 
-    current_file_name_ = fileName;
-    total_file_size_ = fileSize;
-    received_size_ = 0;
-    file_buffer_.clear();
-    file_buffer_.reserve(fileSize);
+// 소멸자
+FileManager::~FileManager() {
+    suspendAllDownloads();
 }
 
-// Base64 ڵ
-std::string FileManager::base64Decode(const std::string& base64) {
+// 파일 다운로드 시작
+void FileManager::startFileDownload(uint32_t transferId, const std::string& fileName, size_t fileSize, size_t offset) {
 
-    static const std::string base64_chars =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
+    std::lock_guard<std::mutex> lock(mutex_);
 
-    std::string decoded;
-    decoded.reserve(base64.size() * 3 / 4);
+    // 같은 ID 나 같은 파일을 받고 있던 전송은 중단 (같은 임시 파일을 쓰지 않도록)
+    for (auto it = transfers_.begin(); it != transfers_.end();) {
+        if (it->first == transferId || it->second->file_name == fileName) {
+            suspendTransfer(*it->second);
+            telemetry_.finishTransfer(it->first);
+            it = transfers_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    boost::filesystem::path download_dir;
+    if (!getDownloadDirectory(download_dir)) {
+        return;
+    }
+
+    std::unique_ptr<Transfer> transfer(new Transfer());
+    transfer->file_name = fileName;
+    transfer->total_file_size = fileSize;
+    transfer->part_path = download_dir / (fileName + PART_EXTENSION);
+    boost::filesystem::path info_path = download_dir / (fileName + PART_INFO_EXTENSION);
+
+    // 이어받기: 이미 받은 부분을 offset 까지 유지
+    boost::system::error_code ec;
+    size_t part_size = 0;
+    if (offset > 0 && boost::filesystem::exists(transfer->part_path, ec)) {
+        part_size = static_cast<size_t>(boost::filesystem::file_size(transfer->part_path, ec));
+    }
+
+    if (offset > 0 && !ec && part_size >= offset && computeFileCrc(transfer->part_path, offset, transfer->received_crc)) {
+
+        boost::filesystem::resize_file(transfer->part_path, offset, ec);
+        transfer->received_size = offset;
+        transfer->part_file.open(transfer->part_path.string(), std::ios::binary | std::ios::in | std::ios::out);
+
+        OutputDebugStringIfNeeded("파일 이어받기: " + fileName + " (" + std::to_string(offset) + " 바이트부터)\n");
+    }
+    else {
 
-    int val = 0, valb = -8;
-    for (unsigned char c : base64) {
-        if (c >= 'A' && c <= 'Z') c = c - 'A';
-        else if (c >= 'a' && c <= 'z') c = c - 'a' + 26;
-        else if (c >= '0' && c <= '9') c = c - '0' + 52;
-        else if (c == '+') c = 62;
-        else if (c == '/') c = 63;
-        else if (c == '=') continue; // е ó
+        transfer->received_crc = 0;
+        transfer->part_file.open(transfer->part_path.string(), std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    }
+
+    if (!transfer->part_file.is_open()) {
+        OutputDebugStringIfNeeded("파일을 열 수 없습니다: " + transfer->part_path.string() + "\n");
+        return;
+    }
+
+    writePartInfo(info_path, fileSize);
+    telemetry_.startTransfer(transferId, fileName, fileSize, transfer->received_size);
+    transfers_[transferId] = std::move(transfer);
+}
+
+// 전송 찾기
+FileManager::Transfer* FileManager::findTransfer(uint32_t transferId) const {
 
-        val = (val << 6) + c;
+    auto it = transfers_.find(transferId);
+    return it != transfers_.end() ? it->second.get() : nullptr;
+}
+
+// 업로드할 파일 열기
+std::shared_ptr<UploadFile> FileManager::openUpload(const std::string& path) {
+
+    boost::system::error_code ec;
+    boost::filesystem::path file_path(path);
+    uint64_t file_size = boost::filesystem::file_size(file_path, ec);
+    if (ec) {
+        OutputDebugStringIfNeeded("업로드할 파일을 열 수 없습니다: " + path + " (" + ec.message() + ")\n");
+        return nullptr;
+    }
+
+    // 빈 파일은 매핑할 수 없으므로 이름과 크기만 보냄
+    std::unique_ptr<boost::interprocess::file_mapping> mapping;
+    if (file_size > 0) {
+        try {
+            mapping.reset(new boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only));
+        }
+        catch (const boost::interprocess::interprocess_exception& e) {
+            OutputDebugStringIfNeeded("업로드할 파일을 매핑할 수 없습니다: " + path + " (" + e.what() + ")\n");
+            return nullptr;
+        }
+    }
+
+    return std::make_shared<UploadFile>(file_path.filename().string(), file_size, std::move(mapping));
+}
+
+// Base64 디코딩
+void FileManager::base64Decode(const std::string& base64, std::vector<char>& decoded) {
+
+    ProfileScope scope("base64Decode");
+
+    // 문자 -> 6비트 값 (패딩과 base64 가 아닌 문자는 -1)
+    static const std::array<int8_t, 256> table = []() {
+        static const char base64_chars[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "abcdefghijklmnopqrstuvwxyz"
+            "0123456789+/";
+
+        std::array<int8_t, 256> values;
+        values.fill(-1);
+        for (int i = 0; i < 64; i++) {
+            values[static_cast<unsigned char>(base64_chars[i])] = static_cast<int8_t>(i);
+        }
+        return values;
+    }();
+
+    decoded.resize(base64.size() / 4 * 3 + 3);
+    char* out = decoded.data();
+
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(base64.data());
+    size_t size = base64.size();
+    size_t i = 0;
+
+    // 4 문자 -> 3 바이트 (패딩이나 다른 문자가 나오면 아래에서 한 문자씩 처리)
+    while (i + 4 <= size) {
+        int a = table[in[i]], b = table[in[i + 1]], c = table[in[i + 2]], d = table[in[i + 3]];
+        if ((a | b | c | d) < 0) {
+            break;
+        }
+
+        uint32_t val = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = static_cast<char>(val >> 16);
+        out[1] = static_cast<char>(val >> 8);
+        out[2] = static_cast<char>(val);
+        out += 3;
+        i += 4;
+    }
+
+    uint32_t val = 0;
+    int valb = -8;
+    for (; i < size; i++) {
+        int c = table[in[i]];
+        if (c < 0) {
+            continue; // 패딩 처리
+        }
+
+        val = (val << 6) | c;
         valb += 6;
         if (valb >= 0) {
-            decoded.push_back(char((val >> valb) & 0xFF));
+            *out++ = static_cast<char>((val >> valb) & 0xFF);
             valb -= 8;
         }
     }
 
-    return decoded;
+    decoded.resize(out - decoded.data());
+}
+
+// 파일 청크 추가 (CRC 정보가 없는 서버용)
+void FileManager::appendFileChunk(uint32_t transferId, const std::string& base64Chunk) {
+
+    ProfileScope scope("appendFileChunk");
+
+    std::vector<char> decoded_chunk;
+    base64Decode(base64Chunk, decoded_chunk);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer) {
+        return;
+    }
+
+    if (!isChunkReceived(*transfer, transfer->received_size)) {
+        writeChunk(*transfer, decoded_chunk.data(), decoded_chunk.size(), transfer->received_size, Crc32c::update(0, decoded_chunk.data(), decoded_chunk.size()));
+        telemetry_.addBytes(transferId, decoded_chunk.size());
+    }
+}
+
+// 파일 청크 추가 (CRC 검증)
+bool FileManager::appendFileChunk(uint32_t transferId, const std::string& base64Chunk, size_t offset, uint32_t chunkCrc, ChunkRange& badRange) {
+
+    ProfileScope scope("appendFileChunk");
+
+    std::vector<char> decoded_chunk;
+    base64Decode(base64Chunk, decoded_chunk);
+    return appendRawChunk(transferId, decoded_chunk.data(), decoded_chunk.size(), offset, chunkCrc, badRange);
+}
+
+// 바이너리 청크 추가
+bool FileManager::appendRawChunk(uint32_t transferId, const char* data, size_t size, size_t offset, uint32_t chunkCrc, ChunkRange& badRange) {
+
+    ProfileScope scope("appendRawChunk");
+
+    // 청크 단위 CRC 검증 (파일에 쓰기 전에 한 번만, 잠그기 전에 계산)
+    uint32_t crc = Crc32c::update(0, data, size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer) {
+        return true;
+    }
+
+    if (crc != chunkCrc || offset + size > transfer->total_file_size) {
+        markCorruptChunk(*transfer, size, offset, badRange);
+        return false;
+    }
+
+    // 중복 청크는 통계에 넣지 않음
+    if (!isChunkReceived(*transfer, offset)) {
+        transfer->corrupt_ranges.erase(offset);
+        writeChunk(*transfer, data, size, offset, chunkCrc);
+        telemetry_.addBytes(transferId, size);
+    }
+
+    if (transfer->end_received) {
+        tryCompleteDownload(transferId);
+    }
+    return true;
 }
 
-//  ûũ ߰
-void FileManager::appendFileChunk(const std::string& base64Chunk) {
+// 큰 청크를 조각으로 기록
+void FileManager::writeChunkSlice(uint32_t transferId, size_t chunkOffset, size_t sliceOffset, const char* data, size_t size) {
+
+    ProfileScope scope("writeChunkSlice");
 
-    std::string decoded_chunk = base64Decode(base64Chunk);
-    file_buffer_.insert(file_buffer_.end(), decoded_chunk.begin(), decoded_chunk.end());
-    received_size_ += decoded_chunk.size();
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer || isChunkReceived(*transfer, chunkOffset) || sliceOffset + size > transfer->total_file_size) {
+        return;
+    }
+
+    // 검증 전이므로 받은 구간에는 아직 반영하지 않음 (CRC 가 틀리면 다시 받은 데이터로 덮어씀)
+    transfer->part_file.seekp(static_cast<std::streamoff>(sliceOffset));
+    transfer->part_file.write(data, size);
+
+    // 큰 청크가 오래 걸려도 멈춤으로 보지 않도록 도착 시각만 갱신 (받은 크기는 검증한 뒤에 셈)
+    telemetry_.markActivity(transferId);
 }
 
-//  ٿε Ϸ
-void FileManager::finishFileDownload() {
+// 조각으로 기록한 청크 검증
+bool FileManager::commitChunkSlices(uint32_t transferId, size_t chunkOffset, size_t chunkSize, uint32_t receivedCrc, uint32_t chunkCrc, ChunkRange& badRange) {
 
-    if (received_size_ == total_file_size_) 
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer) {
+        return true;
+    }
+
+    if (receivedCrc != chunkCrc || chunkOffset + chunkSize > transfer->total_file_size) {
+        markCorruptChunk(*transfer, chunkSize, chunkOffset, badRange);
+        return false;
+    }
+
+    transfer->corrupt_ranges.erase(chunkOffset);
+    if (!isChunkReceived(*transfer, chunkOffset)) {
+        addReceivedChunk(*transfer, chunkSize, chunkOffset, chunkCrc);
+        telemetry_.addBytes(transferId, chunkSize);
+    }
+
+    if (transfer->end_received) {
+        tryCompleteDownload(transferId);
+    }
+    return true;
+}
+
+// 검증된 청크 기록
+void FileManager::writeChunk(Transfer& transfer, const char* data, size_t size, size_t offset, uint32_t chunkCrc) {
+
+    if (isChunkReceived(transfer, offset)) {
+        return; // 이미 받은 구간
+    }
+
+    transfer.part_file.seekp(static_cast<std::streamoff>(offset));
+    transfer.part_file.write(data, size);
+
+    addReceivedChunk(transfer, size, offset, chunkCrc);
+}
+
+// 이미 받았거나 받는 중인 청크인지
+bool FileManager::isChunkReceived(const Transfer& transfer, size_t offset) {
+    return offset < transfer.received_size || transfer.pending_chunks.count(offset) > 0;
+}
+
+// 기록된 청크를 받은 구간에 반영
+void FileManager::addReceivedChunk(Transfer& transfer, size_t size, size_t offset, uint32_t chunkCrc) {
+
+    if (offset != transfer.received_size) {
+        transfer.pending_chunks[offset] = std::make_pair(size, chunkCrc);
+        return;
+    }
+
+    // 연속 구간의 CRC 는 청크 CRC 를 합쳐서 계산 (데이터를 다시 읽지 않음)
+    transfer.received_crc = Crc32c::combine(transfer.received_crc, chunkCrc, size);
+    transfer.received_size += size;
+
+    // 앞 구간이 채워지면서 이어지게 된 청크 합치기
+    auto it = transfer.pending_chunks.find(transfer.received_size);
+    while (it != transfer.pending_chunks.end()) {
+        transfer.received_crc = Crc32c::combine(transfer.received_crc, it->second.second, it->second.first);
+        transfer.received_size += it->second.first;
+        transfer.pending_chunks.erase(it);
+        it = transfer.pending_chunks.find(transfer.received_size);
+    }
+}
+
+// CRC 가 맞지 않는 청크 기록
+void FileManager::markCorruptChunk(Transfer& transfer, size_t size, size_t offset, ChunkRange& badRange) {
+
+    badRange.offset = offset;
+    badRange.length = size;
+    transfer.corrupt_ranges[offset] = size;
+
+    OutputDebugStringIfNeeded("청크 CRC 불일치: " + transfer.file_name + " (" + std::to_string(offset) + ", " + std::to_string(size) + " 바이트)\n");
+}
+
+// 받는 중인 파일 이름
+std::string FileManager::getFileName(uint32_t transferId) const {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    return transfer ? transfer->file_name : std::string();
+}
+
+// 앞에서부터 연속으로 받은 크기와 CRC32C
+bool FileManager::getReceivedPrefix(uint32_t transferId, size_t& size, uint32_t& crc) const {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer) {
+        return false;
+    }
+
+    size = transfer->received_size;
+    crc = transfer->received_crc;
+    return true;
+}
+
+// 임시 파일을 전체 크기로 미리 늘려 둠
+void FileManager::preallocateFile(uint32_t transferId) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer || transfer->total_file_size == 0) {
+        return;
+    }
+
+    // 마지막 바이트를 기록해서 크기를 확보 (중단되면 연속 구간까지 다시 줄임)
+    transfer->part_file.seekp(static_cast<std::streamoff>(transfer->total_file_size - 1));
+    transfer->part_file.put('\0');
+    transfer->part_file.flush();
+}
+
+// 파일 다운로드 완료 (CRC 정보가 없는 서버용)
+bool FileManager::finishFileDownload(uint32_t transferId) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer) {
+        return false;
+    }
+
+    transfer->end_received = true;
+    transfer->verify_file_crc = false;
+    return tryCompleteDownload(transferId);
+}
+
+// 파일 다운로드 완료 (전체 파일 CRC32C 검증)
+bool FileManager::finishFileDownload(uint32_t transferId, uint32_t fileCrc) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Transfer* transfer = findTransfer(transferId);
+    if (!transfer) {
+        return false;
+    }
+
+    transfer->end_received = true;
+    transfer->verify_file_crc = true;
+    transfer->expected_crc = fileCrc;
+    return tryCompleteDownload(transferId);
+}
+
+// 모든 구간을 받았으면 검증 후 저장
+bool FileManager::tryCompleteDownload(uint32_t transferId) {
+
+    auto it = transfers_.find(transferId);
+    if (it == transfers_.end()) {
+        return false;
+    }
+    Transfer& transfer = *it->second;
+
+    // 다시 요청한 구간을 기다리는 중
+    if (!transfer.corrupt_ranges.empty()) {
+        return false;
+    }
+
+    if (transfer.received_size != transfer.total_file_size) 
     {
-        saveFile();
+        OutputDebugStringIfNeeded("파일 크기 불일치: 수신된 크기 " + std::to_string(transfer.received_size) + ", 예상 크기 " + std::to_string(transfer.total_file_size) + "\n");
+        suspendTransfer(transfer);
+        telemetry_.finishTransfer(transferId);
+        transfers_.erase(it);
+        return false;
     }
-    else
+
+    if (transfer.verify_file_crc && transfer.received_crc != transfer.expected_crc)
     {
-        OutputDebugStringIfNeeded(" ũ ġ: ŵ ũ " + std::to_string(received_size_) + ",  ũ " + std::to_string(total_file_size_) + "\n");
+        OutputDebugStringIfNeeded("파일 CRC 불일치: " + transfer.file_name + "\n");
+
+        // 전체가 손상된 파일은 이어받지 않고 처음부터 다시 받음
+        transfer.part_file.close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(transfer.part_path, ec);
+        boost::filesystem::remove(transfer.part_path.parent_path() / (transfer.file_name + PART_INFO_EXTENSION), ec);
+        telemetry_.finishTransfer(transferId);
+        transfers_.erase(it);
+        return false;
     }
+
+    saveFile(transfer);
+    telemetry_.finishTransfer(transferId);
+    transfers_.erase(it);
+    return true;
 }
 
-//  
-void FileManager::saveFile() const {
+// 진행 중인 모든 다운로드 중단
+void FileManager::suspendAllDownloads() {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& transfer : transfers_) {
+        suspendTransfer(*transfer.second);
+    }
+    transfers_.clear();
+    telemetry_.clear();
+}
+
+// 전송 하나 중단
+void FileManager::suspendTransfer(Transfer& transfer) {
+
+    if (transfer.part_file.is_open()) {
+        transfer.part_file.flush();
+        transfer.part_file.close();
+
+        // 이어받기는 연속으로 받은 구간까지만 유효
+        boost::system::error_code ec;
+        boost::filesystem::resize_file(transfer.part_path, transfer.received_size, ec);
+        transfer.pending_chunks.clear();
+        transfer.corrupt_ranges.clear();
+
+        OutputDebugStringIfNeeded("다운로드 중단: " + transfer.file_name + " (" + std::to_string(transfer.received_size) + "/" + std::to_string(transfer.total_file_size) + ")\n");
+    }
+}
+
+// 이어받을 수 있는 다운로드 목록
+std::vector<PartialDownload> FileManager::getPartialDownloads() const {
+
+    // 지금 받는 중인 파일 이름만 잠금 안에서 복사 (CRC 계산 동안 파일 기록 스레드를 막지 않도록)
+    std::set<std::string> receiving_files;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& transfer : transfers_) {
+            receiving_files.insert(transfer.second->file_name);
+        }
+    }
+
+    std::vector<PartialDownload> downloads;
+
+    boost::filesystem::path download_dir;
+    if (!getDownloadDirectory(download_dir)) {
+        return downloads;
+    }
+
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator it(download_dir, ec), end; !ec && it != end; it.increment(ec)) {
 
-    //     
+        const boost::filesystem::path& info_path = it->path();
+        if (info_path.extension() != PART_INFO_EXTENSION) {
+            continue;
+        }
+
+        PartialDownload download;
+        download.fileName = info_path.stem().string();
+
+        // 지금 받는 중인 파일은 제외
+        if (receiving_files.count(download.fileName)) {
+            continue;
+        }
+
+        boost::filesystem::path part_path = download_dir / (download.fileName + PART_EXTENSION);
+        boost::system::error_code size_ec;
+        download.offset = static_cast<size_t>(boost::filesystem::file_size(part_path, size_ec));
+        if (size_ec || !readPartInfo(info_path, download.fileSize) || download.offset > download.fileSize) {
+            continue;
+        }
+
+        if (!computeFileCrc(part_path, download.offset, download.crc)) {
+            continue;
+        }
+
+        downloads.push_back(download);
+    }
+
+    return downloads;
+}
+
+// 전송별 진행 상황
+TransferTelemetry& FileManager::getTelemetry() {
+    return telemetry_;
+}
+
+// 다운로드 폴더 경로
+bool FileManager::getDownloadDirectory(boost::filesystem::path& download_dir) {
+
+    // 현재 실행 파일의 경로 얻기
     char exePath[MAX_PATH];
     if (GetModuleFileNameA(NULL, exePath, MAX_PATH) == 0) {
 
-        OutputDebugStringIfNeeded("  θ   ߽ϴ.\n");
-        return;
+        OutputDebugStringIfNeeded("실행 파일 경로를 가져오는 데 실패했습니다.\n");
+        return false;
     }
 
-    //   ο 丮 
+    // 실행 파일 경로에서 디렉토리 추출
     boost::filesystem::path exe_dir = boost::filesystem::path(exePath).parent_path();
 
-    // 'download'   
-    boost::filesystem::path download_dir = exe_dir / "download";
+    // 'download' 폴더 경로 생성
+    download_dir = exe_dir / "download";
 
-    //    
+    // 폴더가 존재하지 않으면 생성
     if (!boost::filesystem::exists(download_dir)) {
 
         if (!boost::filesystem::create_directory(download_dir))
         {
-            OutputDebugStringIfNeeded("ٿε   ߽ϴ.\n");
-            return;
+            OutputDebugStringIfNeeded("다운로드 폴더 생성에 실패했습니다.\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// 이어받기 정보 기록
+void FileManager::writePartInfo(const boost::filesystem::path& info_path, size_t fileSize) {
+
+    std::ofstream info(info_path.string(), std::ios::trunc);
+    if (info.is_open()) {
+        info << fileSize;
+    }
+}
+
+// 이어받기 정보 읽기
+bool FileManager::readPartInfo(const boost::filesystem::path& info_path, size_t& fileSize) {
+
+    std::ifstream info(info_path.string());
+    return static_cast<bool>(info >> fileSize);
+}
+
+// 파일 앞부분의 CRC32C 계산
+bool FileManager::computeFileCrc(const boost::filesystem::path& file_path, size_t length, uint32_t& crc) {
+
+    std::ifstream file(file_path.string(), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    crc = 0;
+    std::vector<char> buffer(64 * 1024);
+    while (length > 0) {
+        size_t to_read = (std::min)(length, buffer.size());
+        if (!file.read(buffer.data(), to_read)) {
+            return false;
         }
+        crc = Crc32c::update(crc, buffer.data(), to_read);
+        length -= to_read;
     }
 
-    // 'download'     
-    boost::filesystem::path file_path = download_dir / current_file_name_;
+    return true;
+}
+
+// 파일 저장
+void FileManager::saveFile(Transfer& transfer) {
+
+    ProfileScope scope("saveFile");
 
-    //  
-    std::ofstream file(file_path.string(), std::ios::binary);
-    if (file.is_open()) 
+    transfer.part_file.close();
+
+    // 'download' 폴더에 저장할 파일 경로 생성
+    boost::filesystem::path file_path = transfer.part_path.parent_path() / transfer.file_name;
+    boost::filesystem::path info_path = transfer.part_path.parent_path() / (transfer.file_name + PART_INFO_EXTENSION);
+
+    // 임시 파일을 최종 파일로 교체
+    boost::system::error_code ec;
+    boost::filesystem::rename(transfer.part_path, file_path, ec);
+    if (!ec) 
     {
-        file.write(file_buffer_.data(), file_buffer_.size());
-        file.close();
+        boost::filesystem::remove(info_path, ec);
 
-        OutputDebugStringIfNeeded(" Ǿϴ: " + file_path.string() + "\n");
+        OutputDebugStringIfNeeded("파일이 저장되었습니다: " + file_path.string() + "\n");
     }
     else 
     {
 
-        OutputDebugStringIfNeeded("   ϴ: " + file_path.string() + "\n");
+        OutputDebugStringIfNeeded("파일을 저장할 수 없습니다: " + file_path.string() + " (" + ec.message() + ")\n");
+    }
+}
+
+// 생성자
+UploadFile::UploadFile(const std::string& fileName, uint64_t fileSize, std::unique_ptr<boost::interprocess::file_mapping> mapping)
+    : file_name_(fileName), file_size_(fileSize), mapping_(std::move(mapping)) {}
+
+// 파일 이름
+const std::string& UploadFile::getFileName() const {
+    return file_name_;
+}
+
+// 파일 크기
+uint64_t UploadFile::getFileSize() const {
+    return file_size_;
+}
+
+// 구간 매핑
+std::shared_ptr<boost::interprocess::mapped_region> UploadFile::map(uint64_t offset, size_t length) const {
+
+    if (!mapping_ || length == 0 || offset + length > file_size_) {
+        return nullptr;
+    }
+
+    try {
+        auto region = std::make_shared<boost::interprocess::mapped_region>(*mapping_, boost::interprocess::read_only, offset, length);
+
+        // 앞에서부터 한 번만 읽으므로 미리 읽기를 요청
+        region->advise(boost::interprocess::mapped_region::advice_sequential);
+        return region;
+    }
+    catch (const boost::interprocess::interprocess_exception& e) {
+        OutputDebugStringIfNeeded("업로드 구간을 매핑할 수 없습니다: " + file_name_ + " (" + e.what() + ")\n");
+        return nullptr;
     }
 }
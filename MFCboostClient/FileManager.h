@@ -1,29 +1,162 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <fstream>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "TransferTelemetry.h"
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
+// 중단된 다운로드 정보
+struct PartialDownload {
+    std::string fileName; // 파일 이름
+    size_t fileSize; // 파일의 총 크기
+    size_t offset; // 이어받을 위치
+    uint32_t crc; // offset 까지의 CRC32C
+};
+
+// 파일 구간
+struct ChunkRange {
+    size_t offset; // 시작 위치
+    size_t length; // 길이
+};
+
+// 업로드할 파일 (읽기 전용으로 열어 두고 보낼 구간만 그때그때 매핑)
+class UploadFile {
+public:
+    UploadFile(const std::string& fileName, uint64_t fileSize, std::unique_ptr<boost::interprocess::file_mapping> mapping);
+
+    // 파일 이름 (경로 제외)
+    const std::string& getFileName() const;
+
+    // 파일 크기 (바이트)
+    uint64_t getFileSize() const;
+
+    // 구간 매핑 (반환값이 살아 있는 동안 유지, 실패하면 nullptr)
+    std::shared_ptr<boost::interprocess::mapped_region> map(uint64_t offset, size_t length) const;
+
+private:
+    std::string file_name_; // 서버에 알릴 파일 이름
+    uint64_t file_size_; // 파일 크기
+    std::unique_ptr<boost::interprocess::file_mapping> mapping_; // 빈 파일이면 nullptr
+};
+
+// 여러 스레드(io 스레드, 수신 파이프라인 쓰기 스레드)에서 호출해도 됨
 class FileManager {
 public:
     FileManager();
+    ~FileManager();
+
+    // 파일 다운로드 시작 (transferId 로 전송을 구분, offset 이 0 보다 크면 이어받기)
+    void startFileDownload(uint32_t transferId, const std::string& fileName, size_t fileSize, size_t offset = 0);
+
+    // 파일 청크 추가 (CRC 정보가 없는 서버용)
+    void appendFileChunk(uint32_t transferId, const std::string& base64Chunk);
+
+    // 파일 청크 추가 (CRC 불일치 시 다시 받을 구간을 badRange 에 기록하고 false 반환)
+    bool appendFileChunk(uint32_t transferId, const std::string& base64Chunk, size_t offset, uint32_t chunkCrc, ChunkRange& badRange);
+
+    // 디코딩이 필요 없는 바이너리 청크 추가 (CRC 불일치 시 false)
+    bool appendRawChunk(uint32_t transferId, const char* data, size_t size, size_t offset, uint32_t chunkCrc, ChunkRange& badRange);
+
+    // 큰 청크를 조각으로 도착하는 대로 기록 (검증 전 데이터, 아직 받지 않은 청크에만 기록)
+    void writeChunkSlice(uint32_t transferId, size_t chunkOffset, size_t sliceOffset, const char* data, size_t size);
+
+    // 조각으로 기록한 청크 검증 (receivedCrc 는 조각들의 CRC32C, 불일치 시 badRange 에 기록하고 false 반환)
+    bool commitChunkSlices(uint32_t transferId, size_t chunkOffset, size_t chunkSize, uint32_t receivedCrc, uint32_t chunkCrc, ChunkRange& badRange);
+
+    // 받는 중인 파일 이름 (없는 전송이면 빈 문자열)
+    std::string getFileName(uint32_t transferId) const;
 
-    //  ٿε 
-    void startFileDownload(const std::string& fileName, size_t fileSize);
+    // 앞에서부터 연속으로 받은 크기와 CRC32C (없는 전송이면 false)
+    bool getReceivedPrefix(uint32_t transferId, size_t& size, uint32_t& crc) const;
 
-    //  ûũ ߰
-    void appendFileChunk(const std::string& base64Chunk);
+    // 임시 파일을 전체 크기로 미리 늘려 둠 (여러 구간을 제자리에 기록)
+    void preallocateFile(uint32_t transferId);
 
-    //  ٿε Ϸ
-    void finishFileDownload();
+    // 파일 다운로드 완료 (CRC 정보가 없는 서버용)
+    bool finishFileDownload(uint32_t transferId);
+
+    // 파일 다운로드 완료 (전체 파일 CRC32C 검증, 저장되면 true)
+    bool finishFileDownload(uint32_t transferId, uint32_t fileCrc);
+
+    // 진행 중인 모든 다운로드 중단 (받은 부분은 유지)
+    void suspendAllDownloads();
+
+    // 이어받을 수 있는 다운로드 목록
+    std::vector<PartialDownload> getPartialDownloads() const;
+
+    // 전송별 진행 상황 (청크를 기록할 때마다 갱신, UI 등에서 조회하거나 멈춤 이벤트를 받음)
+    TransferTelemetry& getTelemetry();
+
+    // 업로드할 파일 열기 (복사하지 않고 매핑해서 보냄, 실패하면 nullptr)
+    static std::shared_ptr<UploadFile> openUpload(const std::string& path);
+
+    // Base64 디코딩 (decoded 의 버퍼를 재사용)
+    static void base64Decode(const std::string& base64, std::vector<char>& decoded);
+
+    static const size_t MAX_TRANSFERS = 8; // 동시에 받을 수 있는 파일 수
 
 private:
-    //  
-    void saveFile() const;
+    // 받는 중인 파일 하나의 상태
+    struct Transfer {
+        std::string file_name; // 파일 이름
+        boost::filesystem::path part_path; // 받는 중인 임시 파일 경로
+        std::fstream part_file; // 받는 중인 임시 파일
+        size_t total_file_size = 0; // 파일의 총 크기
+        size_t received_size = 0; // 앞에서부터 연속으로 수신된 데이터의 크기
+        uint32_t received_crc = 0; // 연속으로 수신된 데이터의 CRC32C
+        std::map<size_t, std::pair<size_t, uint32_t>> pending_chunks; // 순서가 어긋난 청크 (위치 -> 길이, CRC)
+        std::map<size_t, size_t> corrupt_ranges; // 다시 받아야 할 구간 (위치 -> 길이)
+        bool end_received = false; // file_end 수신 여부
+        bool verify_file_crc = false; // 전체 파일 CRC 검증 여부
+        uint32_t expected_crc = 0; // 서버가 알려준 전체 파일 CRC32C
+    };
+
+    // 전송 찾기 (없으면 nullptr)
+    Transfer* findTransfer(uint32_t transferId) const;
+
+    // 검증된 청크 기록
+    static void writeChunk(Transfer& transfer, const char* data, size_t size, size_t offset, uint32_t chunkCrc);
+
+    // 이미 받았거나 받는 중인 청크인지
+    static bool isChunkReceived(const Transfer& transfer, size_t offset);
+
+    // 기록된 청크를 받은 구간에 반영
+    static void addReceivedChunk(Transfer& transfer, size_t size, size_t offset, uint32_t chunkCrc);
+
+    // CRC 가 맞지 않는 청크 기록
+    static void markCorruptChunk(Transfer& transfer, size_t size, size_t offset, ChunkRange& badRange);
+
+    // 모든 구간을 받았으면 검증 후 저장 (끝난 전송은 목록에서 제거)
+    bool tryCompleteDownload(uint32_t transferId);
+
+    // 전송 하나 중단
+    static void suspendTransfer(Transfer& transfer);
+
+    // 파일 저장
+    static void saveFile(Transfer& transfer);
+
+    // 다운로드 폴더 경로
+    static bool getDownloadDirectory(boost::filesystem::path& download_dir);
+
+    // 이어받기 정보 기록
+    static void writePartInfo(const boost::filesystem::path& info_path, size_t fileSize);
+
+    // 이어받기 정보 읽기
+    static bool readPartInfo(const boost::filesystem::path& info_path, size_t& fileSize);
+
+    // 파일 앞부분의 CRC32C 계산
+    static bool computeFileCrc(const boost::filesystem::path& file_path, size_t length, uint32_t& crc);
 
-    // Base64 ڵ
-    static std::string base64Decode(const std::string& base64);
+    std::map<uint32_t, std::unique_ptr<Transfer>> transfers_; // 받는 중인 파일 (전송 ID -> 상태)
+    mutable std::mutex mutex_; // transfers_ 보호
+    TransferTelemetry telemetry_; // 자체 잠금 사용 (mutex_ 를 잡은 채로 호출해도 됨)
 
-    std::string current_file_name_; //   ̸
-    std::vector<char> file_buffer_; //  ͸  
-    size_t total_file_size_; //   ũ
-    size_t received_size_; // ŵ  ũ
+    static const char* const PART_EXTENSION;
+    static const char* const PART_INFO_EXTENSION;
 };
@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "FrameCapture.h"
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+    // 캡처 파일 식별자
+    const char CAPTURE_MAGIC[8] = { 'M', 'S', 'C', 'A', 'P', 0, 0, 1 };
+
+    // 프레임 레코드 헤더 (뒤에 본문이 이어짐)
+    struct RecordHeader {
+        uint64_t timestamp_us;
+        uint32_t length;
+        uint8_t direction;
+        uint8_t flags;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(RecordHeader) == 16, "RecordHeader 는 16바이트여야 합니다.");
+
+    // 프레임 플래그는 길이 헤더의 상위 비트이므로 상위 8비트만 기록
+    const int RECORD_FLAG_SHIFT = 24;
+}
+
+// 생성자
+FrameRecorder::FrameRecorder() : segment_offset_(0), segment_used_(0) {}
+
+// 소멸자
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+// 캡처 파일 열기
+bool FrameRecorder::open(const std::string& path) {
+
+    close();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 빈 파일 생성
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "캡처 파일을 열 수 없습니다: " << path << std::endl;
+        return false;
+    }
+    file.close();
+
+    path_ = path;
+    start_time_ = std::chrono::steady_clock::now();
+
+    if (!mapSegment(0)) {
+        path_.clear();
+        return false;
+    }
+
+    return writeBytes(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+}
+
+// 캡처 파일 닫기
+void FrameRecorder::close() {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (path_.empty()) {
+        return;
+    }
+
+    region_.reset();
+    mapping_.reset();
+
+    // 미리 늘려 둔 구간 중 사용한 만큼만 남김
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(path_, segment_offset_ + segment_used_, ec);
+
+    path_.clear();
+    segment_offset_ = 0;
+    segment_used_ = 0;
+}
+
+// 프레임 기록
+void FrameRecorder::record(FrameDirection direction, uint32_t flags, const char* data, size_t size) {
+
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!region_) {
+        return;
+    }
+
+    RecordHeader header;
+    header.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(now - start_time_).count();
+    header.length = static_cast<uint32_t>(size);
+    header.direction = static_cast<uint8_t>(direction);
+    header.flags = static_cast<uint8_t>(flags >> RECORD_FLAG_SHIFT);
+    header.reserved = 0;
+
+    writeBytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeBytes(data, size);
+}
+
+// 바이트 기록
+bool FrameRecorder::writeBytes(const char* data, size_t size) {
+
+    while (size > 0) {
+
+        if (segment_used_ == SEGMENT_SIZE && !mapSegment(segment_offset_ + SEGMENT_SIZE)) {
+            return false;
+        }
+
+        size_t to_copy = (std::min)(size, SEGMENT_SIZE - segment_used_);
+        memcpy(static_cast<char*>(region_->get_address()) + segment_used_, data, to_copy);
+        segment_used_ += to_copy;
+        data += to_copy;
+        size -= to_copy;
+    }
+
+    return true;
+}
+
+// 파일의 offset 부터 한 구간 매핑
+bool FrameRecorder::mapSegment(uint64_t offset) {
+
+    region_.reset();
+    mapping_.reset();
+
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(path_, offset + SEGMENT_SIZE, ec);
+    if (ec) {
+        std::cerr << "캡처 파일 크기 변경 실패: " << ec.message() << std::endl;
+        return false;
+    }
+
+    try {
+        mapping_.reset(new boost::interprocess::file_mapping(path_.c_str(), boost::interprocess::read_write));
+        region_.reset(new boost::interprocess::mapped_region(*mapping_, boost::interprocess::read_write, offset, SEGMENT_SIZE));
+    }
+    catch (const boost::interprocess::interprocess_exception& e) {
+        std::cerr << "캡처 파일 매핑 실패: " << e.what() << std::endl;
+        region_.reset();
+        mapping_.reset();
+        return false;
+    }
+
+    segment_offset_ = offset;
+    segment_used_ = 0;
+    return true;
+}
+
+// 캡처 파일 재생
+bool FrameReplayer::replay(const std::string& path, bool realtime, const std::function<void(const CapturedFrame&)>& sink, ReplayStats& stats) {
+
+    stats.frames = 0;
+    stats.bytes = 0;
+    stats.elapsed_seconds = 0;
+
+    std::unique_ptr<boost::interprocess::file_mapping> mapping;
+    std::unique_ptr<boost::interprocess::mapped_region> region;
+    try {
+        mapping.reset(new boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only));
+        region.reset(new boost::interprocess::mapped_region(*mapping, boost::interprocess::read_only));
+    }
+    catch (const boost::interprocess::interprocess_exception& e) {
+        std::cerr << "캡처 파일을 열 수 없습니다: " << e.what() << std::endl;
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(region->get_address());
+    size_t size = region->get_size();
+    if (size < sizeof(CAPTURE_MAGIC) || memcmp(data, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+        std::cerr << "캡처 파일 형식이 아닙니다: " << path << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t pos = sizeof(CAPTURE_MAGIC);
+
+    while (pos + sizeof(RecordHeader) <= size) {
+
+        RecordHeader header;
+        memcpy(&header, data + pos, sizeof(header));
+        pos += sizeof(header);
+
+        // 녹화 중 비정상 종료되어 남은 빈 영역이나 잘린 마지막 레코드는 무시
+        if (header.length == 0 || header.length > size - pos) {
+            break;
+        }
+
+        if (realtime) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(header.timestamp_us));
+        }
+
+        CapturedFrame frame;
+        frame.timestamp_us = header.timestamp_us;
+        frame.direction = static_cast<FrameDirection>(header.direction);
+        frame.flags = static_cast<uint32_t>(header.flags) << RECORD_FLAG_SHIFT;
+        frame.data = data + pos;
+        frame.size = header.length;
+        sink(frame);
+
+        pos += header.length;
+        stats.frames++;
+        stats.bytes += header.length;
+    }
+
+    stats.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
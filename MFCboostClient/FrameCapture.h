@@ -0,0 +1,71 @@
+#pragma once
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <functional>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// 프레임 방향
+enum class FrameDirection : uint8_t {
+    Inbound = 0, // 서버 -> 클라이언트
+    Outbound = 1 // 클라이언트 -> 서버
+};
+
+// 캡처 파일에서 읽은 프레임 (data 는 매핑된 파일을 직접 가리킴)
+struct CapturedFrame {
+    uint64_t timestamp_us; // 녹화 시작부터의 시간 (마이크로초)
+    FrameDirection direction; // 방향
+    uint32_t flags; // 프레임 플래그 (FrameCodec::COMPRESSED_FLAG 등)
+    const char* data; // 프레임 본문
+    size_t size; // 프레임 본문 크기
+};
+
+// 재생 결과
+struct ReplayStats {
+    size_t frames; // 재생한 프레임 수
+    uint64_t bytes; // 재생한 바이트
+    double elapsed_seconds; // 걸린 시간
+};
+
+// 송수신 프레임을 추가 전용 바이너리 파일에 기록 (메모리 매핑 쓰기)
+class FrameRecorder {
+public:
+    FrameRecorder();
+    ~FrameRecorder();
+
+    // 캡처 파일 열기 (기존 파일은 덮어씀)
+    bool open(const std::string& path);
+
+    // 캡처 파일 닫기 (사용하지 않은 뒷부분은 잘라냄)
+    void close();
+
+    // 프레임 기록
+    void record(FrameDirection direction, uint32_t flags, const char* data, size_t size);
+
+private:
+    // 바이트 기록 (구간이 가득 차면 다음 구간을 매핑)
+    bool writeBytes(const char* data, size_t size);
+
+    // 파일의 offset 부터 한 구간 매핑
+    bool mapSegment(uint64_t offset);
+
+    std::mutex mutex_;
+    std::string path_; // 캡처 파일 경로
+    std::unique_ptr<boost::interprocess::file_mapping> mapping_;
+    std::unique_ptr<boost::interprocess::mapped_region> region_;
+    uint64_t segment_offset_; // 현재 매핑된 구간의 파일 내 위치
+    size_t segment_used_; // 현재 구간에서 사용한 바이트
+    std::chrono::steady_clock::time_point start_time_; // 녹화 시작 시간
+
+    static const size_t SEGMENT_SIZE = 16 * 1024 * 1024;
+};
+
+// 캡처 파일 재생
+class FrameReplayer {
+public:
+    // 캡처 파일의 프레임을 순서대로 sink 에 전달 (realtime 이면 녹화 당시 간격 유지, 아니면 최대 속도)
+    static bool replay(const std::string& path, bool realtime, const std::function<void(const CapturedFrame&)>& sink, ReplayStats& stats);
+};
@@ -0,0 +1,89 @@
+// 서버와 함께 빌드하므로 미리 컴파일된 헤더를 사용하지 않음
+#include "FrameCodec.h"
+#include <boost/endian/conversion.hpp>
+#include <lz4.h>
+#include <cstring>
+
+// 길이 헤더 만들기
+uint32_t FrameCodec::encodeHeader(size_t length, uint32_t flags) {
+    return boost::endian::native_to_big(static_cast<uint32_t>(length) | flags);
+}
+
+// 길이 헤더 해석
+void FrameCodec::decodeHeader(uint32_t header, size_t& length, uint32_t& flags) {
+
+    header = boost::endian::big_to_native(header);
+    flags = header & ~LENGTH_MASK;
+    length = header & LENGTH_MASK;
+}
+
+// 프레임 본문 압축
+bool FrameCodec::compress(const char* data, size_t size, std::string& compressed) {
+
+    int bound = LZ4_compressBound(static_cast<int>(size));
+    compressed.resize(sizeof(uint32_t) + bound);
+
+    uint32_t original_size = boost::endian::native_to_big(static_cast<uint32_t>(size));
+    memcpy(&compressed[0], &original_size, sizeof(uint32_t));
+
+    int compressed_size = LZ4_compress_default(data, &compressed[sizeof(uint32_t)], static_cast<int>(size), bound);
+
+    // 줄어들지 않으면 원본 전송
+    if (compressed_size <= 0 || sizeof(uint32_t) + compressed_size >= size) {
+        compressed.clear();
+        return false;
+    }
+
+    compressed.resize(sizeof(uint32_t) + compressed_size);
+    return true;
+}
+
+// 프레임 본문 압축 해제
+bool FrameCodec::decompress(const char* data, size_t size, std::vector<char>& decompressed) {
+
+    if (size < sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t original_size;
+    memcpy(&original_size, data, sizeof(uint32_t));
+    original_size = boost::endian::big_to_native(original_size);
+    if (original_size > MAX_MESSAGE_SIZE) {
+        return false;
+    }
+
+    decompressed.resize(original_size);
+    int result = LZ4_decompress_safe(data + sizeof(uint32_t), decompressed.data(),
+        static_cast<int>(size - sizeof(uint32_t)), static_cast<int>(original_size));
+
+    return result == static_cast<int>(original_size);
+}
+
+// 바이너리 청크 헤더 기록
+void FrameCodec::encodeBinaryChunkHeader(const BinaryChunkHeader& header, char* out) {
+
+    uint32_t transfer_id = boost::endian::native_to_big(header.transfer_id);
+    uint64_t offset = boost::endian::native_to_big(header.offset);
+    uint32_t crc = boost::endian::native_to_big(header.crc);
+
+    memcpy(out, &transfer_id, sizeof(transfer_id));
+    memcpy(out + 4, &offset, sizeof(offset));
+    memcpy(out + 12, &crc, sizeof(crc));
+}
+
+// 바이너리 청크 헤더 읽기
+bool FrameCodec::decodeBinaryChunkHeader(const char* data, size_t size, BinaryChunkHeader& header) {
+
+    if (size < BINARY_CHUNK_HEADER_SIZE) {
+        return false;
+    }
+
+    memcpy(&header.transfer_id, data, sizeof(header.transfer_id));
+    memcpy(&header.offset, data + 4, sizeof(header.offset));
+    memcpy(&header.crc, data + 12, sizeof(header.crc));
+
+    header.transfer_id = boost::endian::big_to_native(header.transfer_id);
+    header.offset = boost::endian::big_to_native(header.offset);
+    header.crc = boost::endian::big_to_native(header.crc);
+    return true;
+}
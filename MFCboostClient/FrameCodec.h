@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 바이너리 파일 청크 프레임 헤더
+struct BinaryChunkHeader {
+    uint32_t transfer_id; // 전송 ID
+    uint64_t offset; // 파일 내 위치
+    uint32_t crc; // 청크 CRC32C
+};
+
+// 길이 접두 프레임 형식 (클라이언트와 C++ 서버가 함께 사용)
+//   [길이 4바이트 big endian (상위 3비트는 플래그)][본문]
+//   압축 프레임 본문: [원본 크기 4바이트 big endian][LZ4 블록]
+//   바이너리 청크 본문: [BinaryChunkHeader 16바이트 big endian][파일 데이터]
+//   제어 메시지 본문: ControlMessage.h 의 고정 배치 형식
+class FrameCodec {
+public:
+    static const uint32_t COMPRESSED_FLAG = 0x80000000; // LZ4 압축 프레임
+    static const uint32_t BINARY_CHUNK_FLAG = 0x40000000; // 바이너리 파일 청크 프레임
+    static const uint32_t CONTROL_FLAG = 0x20000000; // 바이너리 제어 메시지 프레임 (hello 로 협상)
+    static const uint32_t LENGTH_MASK = 0x1FFFFFFF;
+    static const size_t MAX_MESSAGE_SIZE = 100 * 1024 * 1024;
+    static const size_t MIN_COMPRESS_SIZE = 256; // 이보다 작은 프레임은 압축하지 않음
+    static const size_t BINARY_CHUNK_HEADER_SIZE = 16;
+
+    // 길이 헤더 만들기 (big endian)
+    static uint32_t encodeHeader(size_t length, uint32_t flags);
+
+    // 길이 헤더 해석
+    static void decodeHeader(uint32_t header, size_t& length, uint32_t& flags);
+
+    // 프레임 본문 압축 (줄어들지 않으면 false)
+    static bool compress(const char* data, size_t size, std::string& compressed);
+
+    // 프레임 본문 압축 해제
+    static bool decompress(const char* data, size_t size, std::vector<char>& decompressed);
+
+    // 바이너리 청크 헤더 기록 (out 은 BINARY_CHUNK_HEADER_SIZE 바이트)
+    static void encodeBinaryChunkHeader(const BinaryChunkHeader& header, char* out);
+
+    // 바이너리 청크 헤더 읽기
+    static bool decodeBinaryChunkHeader(const char* data, size_t size, BinaryChunkHeader& header);
+};
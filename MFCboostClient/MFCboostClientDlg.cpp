@@ -7,8 +7,10 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <json/json.h>
 #include <iphlpapi.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <sstream>
 #include <string>
 
 #pragma comment(lib, "iphlpapi.lib")
@@ -20,7 +22,7 @@
 
 
 CMFCboostClientDlg::CMFCboostClientDlg(CWnd* pParent /*=nullptr*/)
-	: CDialogEx(IDD_MFCBOOSTCLIENT_DIALOG, pParent)
+	: CDialogEx(IDD_MFCBOOSTCLIENT_DIALOG, pParent), telemetry_ticks_(0), logged_raw_bytes_(0), logged_pipeline_stats_()
 {
 }
 
@@ -40,6 +42,7 @@ BEGIN_MESSAGE_MAP(CMFCboostClientDlg, CDialogEx)
 	ON_BN_CLICKED(IDC_BUTTON1, &CMFCboostClientDlg::OnBnClickedButton1)
 	ON_BN_CLICKED(IDC_BUTTON2, &CMFCboostClientDlg::OnBnClickedButton2)
 	ON_BN_CLICKED(IDC_BUTTON3, &CMFCboostClientDlg::OnBnClickedButton3)
+	ON_WM_TIMER()
 END_MESSAGE_MAP()
 
 BOOL CMFCboostClientDlg::OnInitDialog()
@@ -49,17 +52,37 @@ BOOL CMFCboostClientDlg::OnInitDialog()
     socket_manager_ = SocketManager::create(io_context_);
 
     file_manager_ = std::make_unique<FileManager>();
+    socket_manager_->setMaxTransfers(FileManager::MAX_TRANSFERS);
+
+    striped_downloader_ = StripedDownloader::create(io_context_, *file_manager_);
+
+    // 압축 해제, 디코딩, 파일 기록은 io 스레드 밖에서 처리
+    receive_pipeline_ = std::make_unique<ReceivePipeline>(*file_manager_);
 
     setupSocketListeners();
 
+    // MFCBOOST_TRACE 환경 변수가 있으면 시작부터 구간을 기록하고 종료할 때 그 경로로 저장 (연결 과정까지 보려면)
+    char trace_path[MAX_PATH];
+    DWORD trace_path_length = GetEnvironmentVariableA("MFCBOOST_TRACE", trace_path, MAX_PATH);
+    if (trace_path_length > 0 && trace_path_length < MAX_PATH) {
+        trace_path_ = trace_path;
+        Profiler::start();
+    }
+
+    Profiler::setThreadName("ui");
+
     io_thread_ = std::thread([this]() {
 
+        Profiler::setThreadName("io");
         boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard(io_context_.get_executor());
         io_context_.run();        
         });
 
     updateButtonState(false);
 
+    // 전송 진행 상황은 UI 스레드에서 주기적으로 조회 (io 스레드와 파일 기록 스레드는 건드리지 않음)
+    SetTimer(TELEMETRY_TIMER_ID, TELEMETRY_INTERVAL_MS, nullptr);
+
 	return TRUE;  
 }
 
@@ -72,15 +95,36 @@ void CMFCboostClientDlg::OnPaint()
 void CMFCboostClientDlg::OnCancel()
 {
     should_monitor_network_ = false;
+    KillTimer(TELEMETRY_TIMER_ID);
     if (socket_manager_->isConnected()) {
         socket_manager_->disconnect();
     }
+
+    // 파이프라인 리스너는 log() 로 UI 스레드를 기다리므로 스레드를 join 하기 전에 뗌 (재생 중인 io 스레드도 파이프라인을 기다림)
+    receive_pipeline_->detachListeners();
     io_context_.stop();
 
     if (io_thread_.joinable()) {
         io_thread_.join();
     }
 
+    // 이미 호출 중인 리스너가 보낸 메시지만 처리하면서 남은 프레임을 모두 기록할 때까지 기다림
+    while (!receive_pipeline_->isIdle()) {
+        MSG msg;
+        ::PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+        ::Sleep(1);
+    }
+    receive_pipeline_.reset();
+
+    // io 스레드가 끝나서 실행되지 못한 중단 작업은 여기서 직접
+    striped_downloader_->stop();
+    file_manager_->suspendAllDownloads();
+
+    if (!trace_path_.empty()) {
+        Profiler::stop();
+        Profiler::writeChromeTrace(trace_path_);
+    }
+
 	CDialogEx::OnCancel();
 }
 
@@ -90,22 +134,127 @@ void CMFCboostClientDlg::OnBnClickedButton1()
     CString serverIP;
     m_ctrlIP.GetWindowText(serverIP);
     std::string ip = CT2A(serverIP);
-    int port = 51111;
+
+    // "주소1, 주소2:포트" 처럼 여러 서버를 입력하면 왕복 시간이 가장 짧은 서버에 접속하고 느려지거나 끊기면 옮김
+    std::vector<ServerEndpoint> endpoints;
+    std::replace(ip.begin(), ip.end(), ',', ' ');
+    std::istringstream list(ip);
+    std::string host;
+    while (list >> host) {
+
+        // "tls://주소" 로 입력하면 TLS 포트로 접속, "shm://이름" 이면 같은 컴퓨터의 서버에 공유 메모리로 접속
+        bool tls = host.compare(0, 6, "tls://") == 0;
+        int port = tls ? 51112 : 51111;
+
+        // "주소:포트" 로 포트 지정
+        size_t scheme = host.find("://");
+        size_t colon = host.find(':', scheme == std::string::npos ? 0 : scheme + 3);
+        if (colon != std::string::npos) {
+            port = std::atoi(host.c_str() + colon + 1);
+            host.erase(colon);
+        }
+
+        endpoints.push_back(ServerEndpoint{ host, port });
+    }
+
+    if (endpoints.empty()) {
+        log(_T("서버 주소를 입력하세요."));
+        return;
+    }
 
     log(_T("서버 연결 시도 중..."));
-    socket_manager_->connect(ip, port);
+    socket_manager_->connect(endpoints);
 }
 
 // 메시지 전송
 void CMFCboostClientDlg::OnBnClickedButton2()
 {
+    CString sMsg;
+    m_ctrlMessage.GetWindowText(sMsg);
+
+    // "trace on" 으로 구간 기록을 시작하고 "trace off" 로 멈추면 trace.json 으로 저장 (Perfetto 에서 보기)
+    if (sMsg == _T("trace on")) {
+
+        Profiler::start();
+        log(_T("구간 기록 시작"));
+        m_ctrlMessage.SetWindowText(_T(""));
+        return;
+    }
+    if (sMsg == _T("trace off")) {
+
+        Profiler::stop();
+        log(Profiler::writeChromeTrace("trace.json") ? _T("구간 기록 저장: trace.json") : _T("구간 기록을 저장할 수 없습니다."));
+        m_ctrlMessage.SetWindowText(_T(""));
+        return;
+    }
+
+    // "record 경로" 로 송수신 프레임 녹화를 시작하고 "record off" 로 멈춤 (녹화 파일은 io 스레드에서만 접근)
+    if (sMsg == _T("record off")) {
+
+        boost::asio::post(io_context_, [this]() {
+            socket_manager_->stopRecording();
+            });
+        log(_T("프레임 녹화 중지"));
+        m_ctrlMessage.SetWindowText(_T(""));
+        return;
+    }
+    if (sMsg.Left(7) == _T("record ")) {
+
+        std::string path = CT2A(sMsg.Mid(7));
+        CString target = sMsg.Mid(7);
+        boost::asio::post(io_context_, [this, path, target]() {
+            log(socket_manager_->startRecording(path) ? _T("프레임 녹화 시작: ") + target : _T("녹화 파일을 열 수 없습니다: ") + target);
+            });
+        m_ctrlMessage.SetWindowText(_T(""));
+        return;
+    }
+
+    // "replay 경로" 로 녹화한 수신 프레임을 네트워크 없이 수신 파이프라인에 다시 넣음 (연결하지 않은 상태에서만)
+    if (sMsg.Left(7) == _T("replay ")) {
+
+        if (socket_manager_->isConnected()) {
+            log(_T("연결을 끊은 뒤 재생하세요."));
+            return;
+        }
+
+        std::string path = CT2A(sMsg.Mid(7));
+        CString target = sMsg.Mid(7);
+        boost::asio::post(io_context_, [this, path, target]() {
+
+            ReplayStats stats = {};
+            if (!socket_manager_->replayCapture(path, false, stats)) {
+                log(_T("캡처를 재생할 수 없습니다: ") + target);
+                return;
+            }
+
+            CString sMsg;
+            sMsg.Format(_T("재생 완료: %s (%zu 프레임, %.1f MB, %.2f초)"), target.GetString(), stats.frames, stats.bytes / 1048576.0, stats.elapsed_seconds);
+            log(sMsg);
+            });
+        log(_T("캡처 재생 시작: ") + target);
+        m_ctrlMessage.SetWindowText(_T(""));
+        return;
+    }
+
     if (!socket_manager_->isConnected()) {
         log(_T("서버에 연결되어 있지 않습니다."));
         return;
     }
 
-    CString sMsg;
-    m_ctrlMessage.GetWindowText(sMsg);
+    // "upload 경로" 로 입력하면 파일 업로드 (파일은 매핑해서 복사 없이 보냄)
+    if (sMsg.Left(7) == _T("upload ")) {
+
+        std::string path = CT2A(sMsg.Mid(7));
+        auto file = FileManager::openUpload(path);
+        if (!file || socket_manager_->uploadFile(file) == 0) {
+            log(_T("업로드할 수 없습니다: ") + sMsg.Mid(7));
+            return;
+        }
+
+        log(_T("업로드 시작: ") + CString(file->getFileName().c_str()));
+        m_ctrlMessage.SetWindowText(_T(""));
+        return;
+    }
 
     if (!sMsg.IsEmpty()) {
 
@@ -135,6 +284,7 @@ void CMFCboostClientDlg::OnBnClickedButton3()
     Json::Value json_message;
     json_message["type"] = "filerequest";
     json_message["content"] = "all";
+    file_manager_->getTelemetry().markRequest();
     socket_manager_->send(json_message);
     log(_T("파일 요청"));
 }
@@ -155,36 +305,124 @@ void CMFCboostClientDlg::setupSocketListeners() {
 
             log(_T("받은 내용: ") + CString(message["content"].asCString()));
         }
-        else if (type == "file_start") {
+        else if (type == "upload_ack") {
+
+            CString fileName(message["content"]["filename"].asCString());
+            log((message["content"]["saved"].asBool() ? _T("업로드 완료: ") : _T("업로드 실패: ")) + fileName);
+        }
+        else {
+
+            log(_T("알 수 없는 메시지 타입: ") + CString(type.c_str()));
+        }
+        
+        });
+
+    // 일정 시간 청크가 오지 않은 전송 (OnTimer 에서 확인하므로 UI 스레드에서 호출됨)
+    file_manager_->getTelemetry().setOnStallListener([this](const TransferStats& stats) {
+
+        CString sMsg;
+        sMsg.Format(_T("전송 멈춤: %s (%.0f초 동안 받지 못함, %zu/%zu)"), CString(stats.fileName.c_str()).GetString(), stats.idleSeconds, stats.receivedBytes, stats.fileSize);
+        log(sMsg);
+        });
+
+    // 받은 프레임은 수신 파이프라인으로 (가득 차면 io 스레드가 잠시 수신을 멈춤)
+    socket_manager_->setOnFrameListener([this](uint32_t flags, std::vector<char>& payload) {
+        return receive_pipeline_->submit(flags, payload);
+        });
+
+    // 큰 바이너리 청크는 다 받을 때까지 기다리지 않고 도착하는 조각부터 파일에 기록
+    socket_manager_->setOnFrameSliceListener([](uint32_t flags, size_t) {
+        return ReceivePipeline::acceptsSlices(flags);
+        },
+        [this](const FrameSlice& slice, std::vector<char>& data) {
+        return receive_pipeline_->submitSlice(slice, data);
+        });
+
+    // 파일 메시지가 아닌 메시지는 io 스레드로 돌려보냄
+    receive_pipeline_->setOnMessageListener([this](const Json::Value& message) {
+
+        boost::asio::post(io_context_, [this, message]() {
+            socket_manager_->dispatchMessage(message);
+            });
+
+        });
+
+    // file_start, file_end (쓰기 스레드에서 청크와 같은 순서로 호출, 필드는 프레임 버퍼에서 바로 읽음)
+    receive_pipeline_->setOnFileMessageListener([this](const ControlView& message) {
+
+        if (message.type() == ControlType::FileStart) {
+
+            typedef ControlSchema::FileStart FileStart;
+            uint32_t transferId = message.get<FileStart::TransferId>();
+            std::string fileName = message.get<FileStart::FileName>().to_string();
+            size_t fileSize = static_cast<size_t>(message.get<FileStart::FileSize>());
+            size_t offset = static_cast<size_t>(message.get<FileStart::Offset>());
+
+            file_manager_->startFileDownload(transferId, fileName, fileSize, offset);
+
+            if (offset > 0) {
+                log(_T("파일 이어받기 시작: ") + CString(fileName.c_str()));
+            }
+            else {
+                log(_T("파일 다운로드 시작: ") + CString(fileName.c_str()));
+            }
+
+            // 큰 파일은 이 연결에서 취소하고 여러 연결로 나눠 받음 (연결 생성은 io 스레드에서)
+            if (fileSize - offset >= StripedDownloader::MIN_FILE_SIZE && socket_manager_->supportsStripes()) {
+
+                boost::asio::post(io_context_, [this, transferId, fileName, fileSize]() {
 
-            Json::Value content = message["content"];
-            std::string fileName = content["filename"].asString();
-            size_t fileSize = content["filesize"].asUInt64();
+                    if (!striped_downloader_->start(socket_manager_->getActiveEndpoint().host, socket_manager_->getActiveEndpoint().port, transferId, fileName, fileSize)) {
+                        return;
+                    }
 
-            file_manager_->startFileDownload(fileName, fileSize);
+                    Json::Value cancel;
+                    cancel["type"] = "file_cancel";
+                    cancel["content"]["transfer_id"] = transferId;
+                    socket_manager_->send(cancel);
 
-            log(_T("파일 다운로드 시작: ") + CString(fileName.c_str()));
+                    log(_T("구간 다운로드 시작: ") + CString(fileName.c_str()));
+                    });
+            }
         }
-        else if (type == "file_chunk") {
+        else {
 
-            std::string fileChunk = message["content"].asString();
+            typedef ControlSchema::FileEnd FileEnd;
+            uint32_t transferId = message.get<FileEnd::TransferId>();
+            std::string fileName = message.get<FileEnd::FileName>().to_string();
 
-            file_manager_->appendFileChunk(fileChunk);
+            // 나눠 받는 파일은 모든 구간이 끝났을 때 검증
+            if (striped_downloader_->isDownloading(transferId)) {
+                return;
+            }
+
+            bool saved = message.get<FileEnd::HasCrc>() ? file_manager_->finishFileDownload(transferId, message.get<FileEnd::Crc>()) : file_manager_->finishFileDownload(transferId);
+
+            if (saved) {
+                log(_T("파일 다운로드 완료: ") + CString(fileName.c_str()));
+            }
+            else {
+                log(_T("파일 검증 대기 또는 실패: ") + CString(fileName.c_str()));
+            }
         }
-        else if (type == "file_end") {
 
-            Json::Value content = message["content"];
-            std::string fileName = content["filename"].asString();
+        });
+
+    // CRC 가 맞지 않는 청크 (쓰기 스레드)
+    receive_pipeline_->setOnCorruptChunkListener([this](uint32_t transferId, const ChunkRange& badRange) {
+        requestFileRange(transferId, badRange);
+        });
 
-            file_manager_->finishFileDownload();
+    // 나눠 받은 파일 완료
+    striped_downloader_->setOnCompleteListener([this](const std::string& fileName, bool saved) {
 
+        if (saved) {
             log(_T("파일 다운로드 완료: ") + CString(fileName.c_str()));
         }
         else {
-
-            log(_T("알 수 없는 메시지 타입: ") + CString(type.c_str()));
+            log(_T("파일 검증 실패: ") + CString(fileName.c_str()));
         }
-        
+
         });
 
     // 접속
@@ -197,6 +435,8 @@ void CMFCboostClientDlg::setupSocketListeners() {
         should_monitor_network_ = true;
         startNetworkQualityMonitoring();
 
+        resumePartialDownloads();
+
         });
 
     // 접속 해제
@@ -204,6 +444,12 @@ void CMFCboostClientDlg::setupSocketListeners() {
 
         log(_T("서버 접속 끊김"));
 
+        // 구간 연결은 io 스레드에서만 다루므로 중단도 io 스레드에서 (UI 스레드의 disconnect() 에서도 호출됨)
+        boost::asio::post(io_context_, [this]() {
+            striped_downloader_->stop();
+            file_manager_->suspendAllDownloads();
+            });
+
         updateButtonState(false);
         should_monitor_network_ = false;
 
@@ -220,6 +466,152 @@ void CMFCboostClientDlg::setupSocketListeners() {
 
 }
 
+// 중단된 다운로드 이어받기 요청
+void CMFCboostClientDlg::resumePartialDownloads() {
+
+    for (const PartialDownload& download : file_manager_->getPartialDownloads()) {
+
+        Json::Value content;
+        content["filename"] = download.fileName;
+        content["offset"] = static_cast<Json::UInt64>(download.offset);
+        content["crc"] = download.crc;
+
+        Json::Value json_message;
+        json_message["type"] = "resume";
+        json_message["content"] = content;
+        file_manager_->getTelemetry().markRequest();
+        socket_manager_->send(json_message);
+
+        log(_T("이어받기 요청: ") + CString(download.fileName.c_str()));
+    }
+}
+
+// 손상된 구간 다시 요청
+void CMFCboostClientDlg::requestFileRange(uint32_t transferId, const ChunkRange& range) {
+
+    std::string fileName = file_manager_->getFileName(transferId);
+
+    Json::Value content;
+    content["transfer_id"] = transferId;
+    content["filename"] = fileName;
+    content["offset"] = static_cast<Json::UInt64>(range.offset);
+    content["length"] = static_cast<Json::UInt64>(range.length);
+
+    Json::Value json_message;
+    json_message["type"] = "range_request";
+    json_message["content"] = content;
+    socket_manager_->send(json_message);
+
+    CString sMsg;
+    sMsg.Format(_T("손상된 구간 재요청: %s (%zu, %zu)"), CString(fileName.c_str()).GetString(), range.offset, range.length);
+    log(sMsg);
+}
+
+// 전송 상태 타이머
+void CMFCboostClientDlg::OnTimer(UINT_PTR nIDEvent)
+{
+    if (nIDEvent == TELEMETRY_TIMER_ID) {
+
+        file_manager_->getTelemetry().checkStalls();
+
+        if (++telemetry_ticks_ % PROGRESS_LOG_TICKS == 0) {
+            logTransferProgress();
+            logEndpointHealth();
+            logCompressionStats();
+            logPipelineStats();
+        }
+        return;
+    }
+
+	CDialogEx::OnTimer(nIDEvent);
+}
+
+// 받는 중인 파일의 진행 상황
+void CMFCboostClientDlg::logTransferProgress() {
+
+    for (const TransferStats& stats : file_manager_->getTelemetry().getStats()) {
+
+        CString sMsg;
+        sMsg.Format(_T("%s: %.1f/%.1f MB, %.2f MB/s (평균 %.2f MB/s)"), CString(stats.fileName.c_str()).GetString(),
+            stats.receivedBytes / 1048576.0, stats.fileSize / 1048576.0, stats.goodput / 1048576.0, stats.smoothedGoodput / 1048576.0);
+
+        if (stats.etaSeconds >= 0) {
+            sMsg.AppendFormat(_T(", 남은 시간 %.0f초"), stats.etaSeconds);
+        }
+        if (stats.firstByteSeconds >= 0) {
+            sMsg.AppendFormat(_T(", 첫 바이트 %.0f ms"), stats.firstByteSeconds * 1000);
+        }
+        log(sMsg);
+    }
+}
+
+// 서버별 왕복 시간
+void CMFCboostClientDlg::logEndpointHealth() {
+
+    ServerEndpoint active = socket_manager_->getActiveEndpoint();
+    for (const EndpointHealth& health : socket_manager_->getEndpointHealth()) {
+
+        bool isActive = health.endpoint.host == active.host && health.endpoint.port == active.port;
+
+        CString sMsg;
+        sMsg.Format(_T("%s%s:%d: "), isActive ? _T("* ") : _T(""), CString(health.endpoint.host.c_str()).GetString(), health.endpoint.port);
+        if (health.healthy) {
+            sMsg.AppendFormat(_T("%.1f ms"), health.rttMs);
+        }
+        else if (health.failures > 0) {
+            sMsg.AppendFormat(_T("응답 없음 (%d회)"), health.failures);
+        }
+        else {
+            sMsg.Append(_T("측정 중"));
+        }
+        log(sMsg);
+    }
+}
+
+// 프레임 압축 통계 (누적)
+void CMFCboostClientDlg::logCompressionStats() {
+
+    CompressionStats stats = socket_manager_->getCompressionStats();
+    uint64_t raw_bytes = stats.raw_bytes_sent + stats.raw_bytes_received;
+    if (raw_bytes - logged_raw_bytes_ < COMPRESSION_LOG_MIN_BYTES) {
+        return;
+    }
+    logged_raw_bytes_ = raw_bytes;
+
+    // 실제 크기 / 압축 전 크기 (작을수록 많이 줄어듦)
+    auto ratio = [](uint64_t wire, uint64_t raw) {
+        return raw > 0 ? 100.0 * wire / raw : 100.0;
+    };
+
+    CString sMsg;
+    sMsg.Format(_T("압축: 보냄 %.1f/%.1f MB (%.0f%%), 받음 %.1f/%.1f MB (%.0f%%), 압축 %.0f ms, 해제 %.0f ms"),
+        stats.wire_bytes_sent / 1048576.0, stats.raw_bytes_sent / 1048576.0, ratio(stats.wire_bytes_sent, stats.raw_bytes_sent),
+        stats.wire_bytes_received / 1048576.0, stats.raw_bytes_received / 1048576.0, ratio(stats.wire_bytes_received, stats.raw_bytes_received),
+        stats.compress_time_us / 1000.0, stats.decompress_time_us / 1000.0);
+    log(sMsg);
+}
+
+// 수신 파이프라인 통계 (사용률은 지난 출력 이후 구간)
+void CMFCboostClientDlg::logPipelineStats() {
+
+    PipelineStats stats = receive_pipeline_->getStats();
+    if (stats.frames == logged_pipeline_stats_.frames) {
+        return;
+    }
+
+    double interval_us = PROGRESS_LOG_TICKS * TELEMETRY_INTERVAL_MS * 1000.0;
+
+    CString sMsg;
+    sMsg.Format(_T("수신 파이프라인: 프레임 %llu개, 디코딩 %.0f%%, 쓰기 %.0f%%, 큐 가득 참 %llu회"),
+        stats.frames - logged_pipeline_stats_.frames,
+        100.0 * (stats.decode_busy_us - logged_pipeline_stats_.decode_busy_us) / interval_us,
+        100.0 * (stats.write_busy_us - logged_pipeline_stats_.write_busy_us) / interval_us,
+        stats.full_count - logged_pipeline_stats_.full_count);
+    log(sMsg);
+
+    logged_pipeline_stats_ = stats;
+}
+
 // 로그 메시지
 void CMFCboostClientDlg::log(const CString& message) {
 
@@ -240,7 +632,9 @@ void CMFCboostClientDlg::log(const CString& message) {
 void CMFCboostClientDlg::updateButtonState(bool isConnected) {
 
     m_ctrlConnect.EnableWindow(!isConnected);
-    m_ctrlSend.EnableWindow(isConnected);
+
+    // 전송 버튼은 연결 없이 쓰는 명령 (trace, record, replay) 때문에 항상 사용 가능
+    m_ctrlSend.EnableWindow(TRUE);
     m_ctrlFile.EnableWindow(isConnected);
 }
 
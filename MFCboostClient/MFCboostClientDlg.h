@@ -2,6 +2,8 @@
 
 #include "SocketManager.h"
 #include "FileManager.h"
+#include "StripedDownloader.h"
+#include "ReceivePipeline.h"
 #include <afxwin.h>
 #include <memory>
 #include <thread>
@@ -31,6 +33,7 @@ protected:
 	afx_msg void OnBnClickedButton1();
 	afx_msg void OnBnClickedButton2();
 	afx_msg void OnBnClickedButton3();
+	afx_msg void OnTimer(UINT_PTR nIDEvent);
 
 private:
 	CEdit m_ctrlIP;          
@@ -48,10 +51,27 @@ private:
 	void startNetworkQualityMonitoring(); // 네트워크 품질 모니터링 시작
 	float calculateNetworkQuality(int downstreamBandwidthKbps, int upstreamBandwidthKbps); // 네트워크 품질 계산
 	void sendNetworkQualityToServer(float quality); // 네트워크 품질 정보 서버에 전송
+	void resumePartialDownloads(); // 중단된 다운로드 이어받기 요청
+	void requestFileRange(uint32_t transferId, const ChunkRange& range); // 손상된 구간 다시 요청
+	void logTransferProgress(); // 받는 중인 파일의 진행 상황 출력
+	void logEndpointHealth(); // 서버별 왕복 시간 출력 (서버를 여러 개 입력한 경우)
+	void logCompressionStats(); // 프레임 압축률과 압축에 쓴 시간 출력 (지난 출력 이후 주고받은 데이터가 있을 때만)
+	void logPipelineStats(); // 수신 파이프라인 단계별 사용률과 큐가 가득 찬 횟수 출력 (지난 출력 이후 받은 프레임이 있을 때만)
 
 	boost::asio::io_context io_context_; // Boost ASIO IO 컨텍스트
 	std::shared_ptr<SocketManager> socket_manager_; // 소켓 매니저
 	std::unique_ptr<FileManager> file_manager_; // 파일 매니저
+	std::shared_ptr<StripedDownloader> striped_downloader_; // 큰 파일을 여러 연결로 나눠 받기
+	std::unique_ptr<ReceivePipeline> receive_pipeline_; // 수신 프레임 디코딩, 파일 기록 스레드
+	std::string trace_path_; // 종료할 때 구간 기록을 저장할 경로 (MFCBOOST_TRACE)
 	std::thread io_thread_; // IO 스레드
 	std::atomic<bool> should_monitor_network_; // 네트워크 모니터링 여부
+	int telemetry_ticks_; // 전송 상태 타이머 호출 횟수
+	uint64_t logged_raw_bytes_; // 마지막으로 압축 통계를 출력할 때까지 주고받은 압축 전 바이트
+	PipelineStats logged_pipeline_stats_; // 마지막으로 출력한 파이프라인 통계 (구간 사용률 계산용)
+
+	static const UINT_PTR TELEMETRY_TIMER_ID = 1;
+	static const UINT TELEMETRY_INTERVAL_MS = 1000; // 멈춤 확인 주기
+	static const int PROGRESS_LOG_TICKS = 5; // 진행 상황은 이 횟수마다 출력
+	static const uint64_t COMPRESSION_LOG_MIN_BYTES = 64 * 1024; // 하트비트만 오갈 때는 압축 통계를 출력하지 않음
 };
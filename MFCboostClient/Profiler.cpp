@@ -0,0 +1,183 @@
+#include "pch.h"
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    // 기록한 구간
+    struct ProfileEvent {
+        const char* name;
+        int64_t started; // 나노초
+        int64_t finished;
+        bool async;
+    };
+
+    // 스레드 하나의 버퍼 (그 스레드만 기록하고, 저장할 때는 count 까지만 읽음)
+    struct ThreadBuffer {
+        std::vector<ProfileEvent> events; // EVENTS_PER_THREAD 크기로 고정
+        std::atomic<size_t> count{ 0 }; // 기록을 마친 구간 수
+        std::atomic<uint32_t> generation{ 0 }; // 기록한 세션 (start() 마다 바뀜)
+        std::atomic<uint64_t> dropped{ 0 }; // 버퍼가 가득 차서 버린 구간 수
+        uint32_t thread_id = 0; // trace 의 tid
+        const char* name = nullptr; // 스레드 이름
+    };
+
+    std::mutex registry_mutex; // buffers, 스레드 이름 보호 (스레드마다 처음 한 번과 저장할 때만 잠금)
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // 끝난 스레드의 버퍼도 저장할 때까지 유지
+    std::atomic<uint32_t> generation{ 0 };
+    std::atomic<int64_t> session_start{ 0 };
+
+    thread_local ThreadBuffer* current_buffer = nullptr;
+    thread_local const char* current_name = nullptr;
+
+    // 현재 스레드의 버퍼 (처음 기록할 때 생성)
+    ThreadBuffer* threadBuffer() {
+
+        if (!current_buffer) {
+            std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+            buffer->events.resize(Profiler::EVENTS_PER_THREAD);
+
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            buffer->thread_id = static_cast<uint32_t>(buffers.size() + 1);
+            buffer->name = current_name;
+            current_buffer = buffer.get();
+            buffers.push_back(std::move(buffer));
+        }
+        return current_buffer;
+    }
+
+    // trace 시각 (세션 시작부터 마이크로초)
+    double traceTime(int64_t ns) {
+        return (ns - session_start.load()) / 1000.0;
+    }
+}
+
+std::atomic<bool> Profiler::enabled_(false);
+
+// 기록 시작
+void Profiler::start() {
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    // 버퍼는 각 스레드가 다음에 기록할 때 세션이 바뀐 것을 보고 비움
+    session_start = now();
+    generation.fetch_add(1, std::memory_order_release);
+    enabled_ = true;
+}
+
+// 기록 중지
+void Profiler::stop() {
+    enabled_ = false;
+}
+
+// 현재 시각
+int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 현재 스레드 이름
+void Profiler::setThreadName(const char* name) {
+
+    current_name = name;
+
+    if (current_buffer) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        current_buffer->name = name;
+    }
+}
+
+// 구간 하나 기록
+void Profiler::record(const char* name, int64_t started, int64_t finished, bool async) {
+
+    ThreadBuffer* buffer = threadBuffer();
+
+    uint32_t current = generation.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != current) {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation.store(current, std::memory_order_release);
+    }
+
+    // 이전 세션에 시작한 구간은 버림
+    if (started < session_start.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= buffer->events.size()) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ProfileEvent& event = buffer->events[index];
+    event.name = name;
+    event.started = started;
+    event.finished = finished;
+    event.async = async;
+
+    // 구간을 다 쓴 뒤에 수를 늘려서 저장하는 스레드가 쓰다 만 구간을 읽지 않게 함
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+// Chrome trace event JSON 으로 저장
+bool Profiler::writeChromeTrace(const std::string& path) {
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    uint32_t current = generation.load(std::memory_order_acquire);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+
+    bool first = true;
+    uint64_t async_id = 0;
+    for (const auto& buffer : buffers) {
+
+        if (buffer->generation.load(std::memory_order_acquire) != current) {
+            continue;
+        }
+
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        uint32_t tid = buffer->thread_id;
+
+        if (buffer->name) {
+            out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+            first = false;
+        }
+
+        // 처리 구간은 스레드 트랙에, 소켓 대기처럼 겹치는 비동기 구간은 별도 트랙에 표시
+        for (size_t i = 0; i < count; ++i) {
+
+            const ProfileEvent& event = buffer->events[i];
+            out << (first ? "" : ",\n");
+            first = false;
+
+            if (event.async) {
+                ++async_id;
+                out << "{\"ph\":\"b\",\"cat\":\"async\",\"name\":\"" << event.name << "\",\"id\":" << async_id << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << traceTime(event.started) << "},\n"
+                    << "{\"ph\":\"e\",\"cat\":\"async\",\"name\":\"" << event.name << "\",\"id\":" << async_id << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << traceTime(event.finished) << "}";
+            }
+            else {
+                out << "{\"ph\":\"X\",\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << traceTime(event.started) << ",\"dur\":" << (event.finished - event.started) / 1000.0 << "}";
+            }
+        }
+
+        uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            out << (first ? "" : ",\n") << "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"dropped " << dropped << " events\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << traceTime(now()) << "}";
+            first = false;
+        }
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// 비동기 작업과 처리 구간을 기록해서 Chrome trace event JSON 으로 저장 (Perfetto, chrome://tracing 에서 보기)
+// 스레드마다 자기 버퍼에만 기록하므로 잠금이 없고, 꺼져 있으면 원자 변수 하나만 읽음
+// PROFILER_DISABLED 를 정의하고 빌드하면 isEnabled() 가 상수 false 가 되어 기록 코드가 모두 빠짐
+class Profiler {
+public:
+    // 기록 시작 (이전 기록은 버림)
+    static void start();
+
+    // 기록 중지
+    static void stop();
+
+#ifdef PROFILER_DISABLED
+    static bool isEnabled() {
+        return false;
+    }
+#else
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+#endif
+
+    // 현재 시각 (나노초)
+    static int64_t now();
+
+    // 비동기 작업 시작 시각 (꺼져 있으면 0, 완료 핸들러로 넘겨서 endAsync 에 전달)
+    static int64_t begin() {
+        return isEnabled() ? now() : 0;
+    }
+
+    // 비동기 작업 구간 기록 (소켓 읽기/쓰기처럼 다른 구간과 겹치는 대기 시간)
+    static void endAsync(const char* name, int64_t started) {
+        if (started != 0 && isEnabled()) {
+            record(name, started, now(), true);
+        }
+    }
+
+    // 현재 스레드 이름 (trace 에 표시, name 은 프로그램이 끝날 때까지 유효해야 함)
+    static void setThreadName(const char* name);
+
+    // 기록한 구간을 Chrome trace event JSON 으로 저장 (stop() 후 호출)
+    static bool writeChromeTrace(const std::string& path);
+
+    // 구간 하나 기록 (name 은 문자열 상수)
+    static void record(const char* name, int64_t started, int64_t finished, bool async);
+
+    static const size_t EVENTS_PER_THREAD = 64 * 1024; // 넘치면 이후 구간은 버림
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// 블록 하나의 처리 구간 기록
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name_(Profiler::isEnabled() ? name : nullptr), started_(name_ ? Profiler::now() : 0) {}
+
+    ~ProfileScope() {
+        if (name_) {
+            Profiler::record(name_, started_, Profiler::now(), false);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_; // 꺼져 있었으면 nullptr
+    int64_t started_;
+};
@@ -0,0 +1,418 @@
+#include "pch.h"
+#include "ReceivePipeline.h"
+#include "Crc32c.h"
+#include "Profiler.h"
+#include <iostream>
+
+namespace {
+
+    // 경과 시간 (마이크로초)
+    uint64_t elapsedMicroseconds(std::chrono::steady_clock::time_point started) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count());
+    }
+}
+
+// 생성자
+ReceivePipeline::ReceivePipeline(FileManager& file_manager) : file_manager_(file_manager),
+    inbound_queue_(QUEUE_CAPACITY),
+    write_queue_(QUEUE_CAPACITY),
+    slice_header_valid_(false),
+    slice_crc_(0),
+    stopping_(false),
+    listeners_detached_(false),
+    frames_(0),
+    full_count_(0),
+    decode_busy_us_(0),
+    write_busy_us_(0) {
+
+    decode_thread_ = std::thread(&ReceivePipeline::decodeLoop, this);
+    write_thread_ = std::thread(&ReceivePipeline::writeLoop, this);
+}
+
+// 소멸자 (남은 프레임은 버림)
+ReceivePipeline::~ReceivePipeline() {
+
+    stopping_ = true;
+
+    for (Signal* signal : { &inbound_ready_, &write_ready_, &write_space_ }) {
+        std::lock_guard<std::mutex> lock(signal->mutex);
+        signal->condition.notify_all();
+    }
+
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+    if (write_thread_.joinable()) {
+        write_thread_.join();
+    }
+}
+
+// 받은 프레임 넘기기
+bool ReceivePipeline::submit(uint32_t flags, std::vector<char>& payload) {
+
+    InboundFrame* frame = inbound_queue_.acquire();
+    if (!frame) {
+        full_count_++;
+        return false;
+    }
+
+    // 슬롯에 남아 있던 버퍼를 돌려받아 다음 수신에 재사용
+    frame->flags = flags;
+    frame->data.swap(payload);
+    frame->frame_size = 0;
+    frame->slice_offset = 0;
+    inbound_queue_.publish();
+    frames_++;
+
+    inbound_ready_.notify();
+    return true;
+}
+
+// 큰 바이너리 청크 프레임의 조각 넘기기
+bool ReceivePipeline::submitSlice(const FrameSlice& slice, std::vector<char>& data) {
+
+    InboundFrame* frame = inbound_queue_.acquire();
+    if (!frame) {
+        full_count_++;
+        return false;
+    }
+
+    frame->flags = slice.flags;
+    frame->data.swap(data);
+    frame->frame_size = slice.frame_size;
+    frame->slice_offset = slice.offset;
+    inbound_queue_.publish();
+
+    if (slice.offset == 0) {
+        frames_++;
+    }
+
+    inbound_ready_.notify();
+    return true;
+}
+
+// 조각으로 받을 프레임인지
+bool ReceivePipeline::acceptsSlices(uint32_t flags) {
+    return (flags & FrameCodec::BINARY_CHUNK_FLAG) != 0;
+}
+
+// 파일 메시지가 아닌 메시지 리스너 설정
+void ReceivePipeline::setOnMessageListener(std::function<void(const Json::Value&)> listener) {
+    on_message_ = listener;
+}
+
+// file_start, file_end 리스너 설정
+void ReceivePipeline::setOnFileMessageListener(std::function<void(const ControlView&)> listener) {
+    on_file_message_ = listener;
+}
+
+// CRC 가 맞지 않는 청크 리스너 설정
+void ReceivePipeline::setOnCorruptChunkListener(std::function<void(uint32_t, const ChunkRange&)> listener) {
+    on_corrupt_chunk_ = listener;
+}
+
+// 리스너 호출 중지
+void ReceivePipeline::detachListeners() {
+    listeners_detached_ = true;
+}
+
+// 남은 프레임이 없는지 (디코딩 스레드는 쓰기 큐에 넘긴 뒤에 슬롯을 돌려주므로 수신 큐부터 확인)
+bool ReceivePipeline::isIdle() const {
+    return inbound_queue_.empty() && write_queue_.empty();
+}
+
+// 통계
+PipelineStats ReceivePipeline::getStats() const {
+
+    PipelineStats stats;
+    stats.frames = frames_;
+    stats.full_count = full_count_;
+    stats.decode_busy_us = decode_busy_us_;
+    stats.write_busy_us = write_busy_us_;
+    return stats;
+}
+
+// 디코딩 스레드
+void ReceivePipeline::decodeLoop() {
+
+    Profiler::setThreadName("decode");
+
+    while (!stopping_) {
+
+        InboundFrame* frame = inbound_queue_.front();
+        if (!frame) {
+            inbound_ready_.wait([this]() { return stopping_ || !inbound_queue_.empty(); });
+            continue;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        ProfileScope scope("decode");
+        decode(*frame);
+        inbound_queue_.release();
+        decode_busy_us_ += elapsedMicroseconds(started);
+    }
+}
+
+// 프레임 하나 디코딩
+void ReceivePipeline::decode(InboundFrame& frame) {
+
+    if (frame.frame_size > 0) {
+        decodeSlice(frame);
+        return;
+    }
+
+    if (frame.flags & FrameCodec::CONTROL_FLAG) {
+        decodeControl(frame);
+        return;
+    }
+
+    // 바이너리 청크는 프레임 버퍼를 그대로 쓰기 단계로 넘김 (복사 없음)
+    if (frame.flags & FrameCodec::BINARY_CHUNK_FLAG) {
+
+        BinaryChunkHeader header;
+        if (!FrameCodec::decodeBinaryChunkHeader(frame.data.data(), frame.data.size(), header)) {
+            std::cerr << "잘못된 바이너리 청크." << std::endl;
+            return;
+        }
+
+        WriteItem* item = acquireWriteItem();
+        if (!item) {
+            return;
+        }
+
+        item->kind = WriteItem::Chunk;
+        item->transfer_id = header.transfer_id;
+        item->offset = static_cast<size_t>(header.offset);
+        item->crc = header.crc;
+        item->data.swap(frame.data);
+        item->data_offset = FrameCodec::BINARY_CHUNK_HEADER_SIZE;
+        write_queue_.publish();
+        write_ready_.notify();
+        return;
+    }
+
+    const std::vector<char>* payload = &frame.data;
+    if (frame.flags & FrameCodec::COMPRESSED_FLAG) {
+        if (!FrameCodec::decompress(frame.data.data(), frame.data.size(), decompress_buffer_)) {
+            std::cerr << "압축 해제 실패." << std::endl;
+            return;
+        }
+        payload = &decompress_buffer_;
+    }
+
+    Json::Value message;
+    Json::Reader reader;
+    if (!reader.parse(payload->data(), payload->data() + payload->size(), message)) {
+        std::cerr << "메시지 파싱 실패." << std::endl;
+        return;
+    }
+
+    std::string type = message["type"].asString();
+
+    if (type == "file_chunk") {
+
+        WriteItem* item = acquireWriteItem();
+        if (!item) {
+            return;
+        }
+
+        const Json::Value& content = message["content"];
+        if (content.isObject()) {
+
+            item->kind = WriteItem::Chunk;
+            item->transfer_id = content.get("transfer_id", 0).asUInt();
+            item->offset = content["offset"].asUInt64();
+            item->crc = content["crc"].asUInt();
+            FileManager::base64Decode(content["data"].asString(), item->data);
+        }
+        else {
+
+            // CRC 정보가 없는 서버: 받은 순서대로 기록
+            std::string base64 = content.asString();
+            item->kind = WriteItem::LegacyChunk;
+            item->transfer_id = 0;
+            item->data.assign(base64.begin(), base64.end());
+        }
+
+        item->data_offset = 0;
+        write_queue_.publish();
+        write_ready_.notify();
+    }
+    else if (type == "file_start" || type == "file_end") {
+
+        // 쓰기 단계는 바이너리 형식만 다루도록 옮겨 둠
+        WriteItem* item = acquireWriteItem();
+        if (!item || !ControlMessage::fromJson(message, item->data)) {
+            return;
+        }
+
+        item->kind = WriteItem::FileMessage;
+        item->data_offset = 0;
+        write_queue_.publish();
+        write_ready_.notify();
+    }
+    else if (on_message_ && !listeners_detached_) {
+
+        on_message_(message);
+    }
+}
+
+// 바이너리 제어 메시지 프레임 디코딩
+void ReceivePipeline::decodeControl(InboundFrame& frame) {
+
+    ControlView view;
+    if (!view.parse(frame.data.data(), frame.data.size())) {
+        std::cerr << "잘못된 제어 메시지." << std::endl;
+        return;
+    }
+
+    if (view.type() != ControlType::FileStart && view.type() != ControlType::FileEnd) {
+        if (on_message_ && !listeners_detached_) {
+            on_message_(ControlMessage::toJson(view));
+        }
+        return;
+    }
+
+    WriteItem* item = acquireWriteItem();
+    if (!item) {
+        return;
+    }
+
+    item->kind = WriteItem::FileMessage;
+    item->data.swap(frame.data);
+    item->data_offset = 0;
+    write_queue_.publish();
+    write_ready_.notify();
+}
+
+// 바이너리 청크 프레임의 조각 하나 디코딩
+void ReceivePipeline::decodeSlice(InboundFrame& frame) {
+
+    size_t data_offset = 0;
+
+    // 첫 조각 앞에 청크 헤더가 있음
+    if (frame.slice_offset == 0) {
+
+        slice_header_valid_ = acceptsSlices(frame.flags)
+            && FrameCodec::decodeBinaryChunkHeader(frame.data.data(), frame.data.size(), slice_header_);
+        if (!slice_header_valid_) {
+            std::cerr << "잘못된 바이너리 청크." << std::endl;
+            return;
+        }
+
+        data_offset = FrameCodec::BINARY_CHUNK_HEADER_SIZE;
+    }
+
+    if (!slice_header_valid_) {
+        return;
+    }
+
+    WriteItem* item = acquireWriteItem();
+    if (!item) {
+        return;
+    }
+
+    item->kind = WriteItem::ChunkSlice;
+    item->transfer_id = slice_header_.transfer_id;
+    item->chunk_offset = static_cast<size_t>(slice_header_.offset);
+    item->chunk_size = frame.frame_size - FrameCodec::BINARY_CHUNK_HEADER_SIZE;
+    item->offset = item->chunk_offset + frame.slice_offset + data_offset - FrameCodec::BINARY_CHUNK_HEADER_SIZE;
+    item->crc = slice_header_.crc;
+    item->last_slice = frame.slice_offset + frame.data.size() == frame.frame_size;
+    item->data.swap(frame.data);
+    item->data_offset = data_offset;
+    write_queue_.publish();
+    write_ready_.notify();
+}
+
+// 쓰기 큐의 빈 슬롯
+ReceivePipeline::WriteItem* ReceivePipeline::acquireWriteItem() {
+
+    for (;;) {
+
+        WriteItem* item = write_queue_.acquire();
+        if (item || stopping_) {
+            return item;
+        }
+
+        // 디스크가 느리면 여기서 기다리고, 그동안 디코딩 큐가 차면 io 스레드가 수신을 멈춤
+        write_space_.wait([this]() { return stopping_ || !write_queue_.full(); });
+    }
+}
+
+// 쓰기 스레드
+void ReceivePipeline::writeLoop() {
+
+    Profiler::setThreadName("write");
+
+    while (!stopping_) {
+
+        WriteItem* item = write_queue_.front();
+        if (!item) {
+            write_ready_.wait([this]() { return stopping_ || !write_queue_.empty(); });
+            continue;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+
+        switch (item->kind) {
+
+        case WriteItem::Chunk: {
+
+            ChunkRange badRange;
+            const char* data = item->data.data() + item->data_offset;
+            size_t size = item->data.size() - item->data_offset;
+            if (!file_manager_.appendRawChunk(item->transfer_id, data, size, item->offset, item->crc, badRange) && on_corrupt_chunk_ && !listeners_detached_) {
+                on_corrupt_chunk_(item->transfer_id, badRange);
+            }
+            break;
+        }
+
+        case WriteItem::ChunkSlice:
+            writeSlice(*item);
+            break;
+
+        case WriteItem::LegacyChunk:
+            file_manager_.appendFileChunk(item->transfer_id, std::string(item->data.begin(), item->data.end()));
+            break;
+
+        case WriteItem::FileMessage: {
+
+            ControlView view;
+            if (on_file_message_ && !listeners_detached_ && view.parse(item->data.data(), item->data.size())) {
+                ProfileScope scope("on_file_message");
+                on_file_message_(view);
+            }
+            break;
+        }
+        }
+
+        write_queue_.release();
+        write_space_.notify();
+        write_busy_us_ += elapsedMicroseconds(started);
+    }
+}
+
+// 조각 기록
+void ReceivePipeline::writeSlice(WriteItem& item) {
+
+    const char* data = item.data.data() + item.data_offset;
+    size_t size = item.data.size() - item.data_offset;
+
+    // 조각의 CRC 를 이어서 계산하고 마지막 조각에서 청크 CRC 와 비교
+    if (item.offset == item.chunk_offset) {
+        slice_crc_ = 0;
+    }
+    slice_crc_ = Crc32c::update(slice_crc_, data, size);
+
+    file_manager_.writeChunkSlice(item.transfer_id, item.chunk_offset, item.offset, data, size);
+
+    if (!item.last_slice) {
+        return;
+    }
+
+    ChunkRange badRange;
+    if (!file_manager_.commitChunkSlices(item.transfer_id, item.chunk_offset, item.chunk_size, slice_crc_, item.crc, badRange) && on_corrupt_chunk_ && !listeners_detached_) {
+        on_corrupt_chunk_(item.transfer_id, badRange);
+    }
+}
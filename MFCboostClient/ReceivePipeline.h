@@ -0,0 +1,148 @@
+#pragma once
+#include "ControlMessage.h"
+#include "FileManager.h"
+#include "FrameCodec.h"
+#include "SocketManager.h"
+#include "SpscQueue.h"
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 파이프라인 통계
+struct PipelineStats {
+    uint64_t frames; // 받은 프레임 수
+    uint64_t full_count; // 디코딩 큐가 가득 차서 수신을 멈춘 횟수
+    uint64_t decode_busy_us; // 디코딩 스레드 처리 시간
+    uint64_t write_busy_us; // 쓰기 스레드 처리 시간
+};
+
+// 수신 처리 파이프라인
+// io 스레드(프레임 수신) -> 디코딩 스레드(압축 해제, JSON, Base64) -> 쓰기 스레드(CRC 검증, 파일 기록)
+// 단계 사이는 SPSC 큐로 넘기고 슬롯의 버퍼를 바꿔 끼워서 재사용
+class ReceivePipeline {
+public:
+    explicit ReceivePipeline(FileManager& file_manager);
+    ~ReceivePipeline();
+
+    // io 스레드: 받은 프레임을 넘기고 payload 는 이전에 쓰던 버퍼로 바꿔 받음 (큐가 가득 차면 false)
+    bool submit(uint32_t flags, std::vector<char>& payload);
+
+    // io 스레드: 큰 바이너리 청크 프레임의 조각을 넘김 (프레임 순서대로, 큐가 가득 차면 false)
+    bool submitSlice(const FrameSlice& slice, std::vector<char>& data);
+
+    // 조각으로 받을 프레임인지 (바이너리 청크만 조각째 파일에 기록)
+    static bool acceptsSlices(uint32_t flags);
+
+    // 파일 메시지가 아닌 메시지 리스너 설정 (디코딩 스레드에서 호출)
+    void setOnMessageListener(std::function<void(const Json::Value&)> listener);
+
+    // file_start, file_end 리스너 설정 (쓰기 스레드에서 청크와 같은 순서로 호출)
+    // JSON 으로 받은 메시지도 바이너리 형식으로 옮겨서 전달하고, view 는 호출 중에만 유효
+    void setOnFileMessageListener(std::function<void(const ControlView&)> listener);
+
+    // CRC 가 맞지 않는 청크 리스너 설정 (쓰기 스레드에서 호출)
+    void setOnCorruptChunkListener(std::function<void(uint32_t, const ChunkRange&)> listener);
+
+    // 이후로 리스너를 호출하지 않음 (종료 전에 UI 등 리스너가 기다리는 스레드를 풀어 주려고 호출, 남은 프레임은 계속 기록)
+    void detachListeners();
+
+    // 받은 프레임을 모두 처리했는지
+    bool isIdle() const;
+
+    // 통계
+    PipelineStats getStats() const;
+
+    static const size_t QUEUE_CAPACITY = 64; // 단계마다 대기할 수 있는 프레임 수
+
+private:
+    // io 스레드 -> 디코딩 스레드
+    struct InboundFrame {
+        uint32_t flags = 0; // 프레임 플래그
+        std::vector<char> data; // 프레임 본문 (조각이면 조각 데이터)
+        size_t frame_size = 0; // 조각이면 프레임 본문 전체 크기 (프레임 전체면 0)
+        size_t slice_offset = 0; // 조각의 본문 안 위치
+    };
+
+    // 디코딩 스레드 -> 쓰기 스레드
+    struct WriteItem {
+        enum Kind { Chunk, LegacyChunk, ChunkSlice, FileMessage };
+        Kind kind = Chunk;
+        uint32_t transfer_id = 0; // 전송 ID
+        size_t offset = 0; // 청크 위치 (조각이면 조각 위치)
+        size_t chunk_offset = 0; // 조각이 속한 청크의 위치
+        size_t chunk_size = 0; // 조각이 속한 청크의 크기
+        bool last_slice = false; // 청크의 마지막 조각
+        uint32_t crc = 0; // 청크 CRC32C
+        std::vector<char> data; // 청크 데이터 (바이너리 청크면 프레임 전체, 파일 메시지면 바이너리 제어 메시지)
+        size_t data_offset = 0; // data 안에서 청크가 시작하는 위치
+    };
+
+    // 비어 있거나 가득 찬 큐를 기다리는 스레드 깨우기 (기다리는 쪽이 있을 때만 잠금)
+    struct Signal {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::atomic<bool> waiting{ false };
+
+        void notify() {
+            if (waiting) {
+                std::lock_guard<std::mutex> lock(mutex);
+                condition.notify_one();
+            }
+        }
+
+        template <typename Predicate>
+        void wait(Predicate predicate) {
+            std::unique_lock<std::mutex> lock(mutex);
+            waiting = true;
+            condition.wait_for(lock, std::chrono::milliseconds(10), predicate);
+            waiting = false;
+        }
+    };
+
+    // 단계별 스레드
+    void decodeLoop();
+    void writeLoop();
+
+    // 프레임 하나 디코딩
+    void decode(InboundFrame& frame);
+
+    // 바이너리 제어 메시지 프레임 디코딩 (파일 메시지는 프레임 버퍼째 쓰기 단계로 넘김)
+    void decodeControl(InboundFrame& frame);
+
+    // 바이너리 청크 프레임의 조각 하나 디코딩
+    void decodeSlice(InboundFrame& frame);
+
+    // 쓰기 스레드: 조각 기록 (마지막 조각이면 청크 검증)
+    void writeSlice(WriteItem& item);
+
+    // 쓰기 큐의 빈 슬롯 (가득 차 있으면 기다림, 종료 중이면 nullptr)
+    WriteItem* acquireWriteItem();
+
+    FileManager& file_manager_;
+    SpscQueue<InboundFrame> inbound_queue_;
+    SpscQueue<WriteItem> write_queue_;
+    Signal inbound_ready_; // 디코딩 스레드 깨우기
+    Signal write_ready_; // 쓰기 스레드 깨우기
+    Signal write_space_; // 쓰기 큐가 비었음을 디코딩 스레드에 알림
+    std::vector<char> decompress_buffer_; // 압축 해제용 버퍼 (디코딩 스레드 전용)
+    BinaryChunkHeader slice_header_; // 조각으로 받는 청크의 헤더 (디코딩 스레드 전용)
+    bool slice_header_valid_; // 조각으로 받는 청크의 헤더가 올바른지 (디코딩 스레드 전용)
+    uint32_t slice_crc_; // 조각으로 받는 청크의 CRC32C (쓰기 스레드 전용)
+    std::function<void(const Json::Value&)> on_message_;
+    std::function<void(const ControlView&)> on_file_message_;
+    std::function<void(uint32_t, const ChunkRange&)> on_corrupt_chunk_;
+    std::atomic<bool> stopping_;
+    std::atomic<bool> listeners_detached_; // 리스너 호출 중지
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> full_count_;
+    std::atomic<uint64_t> decode_busy_us_;
+    std::atomic<uint64_t> write_busy_us_;
+    std::thread decode_thread_;
+    std::thread write_thread_;
+};
@@ -0,0 +1,662 @@
+// 서버와 함께 빌드하므로 미리 컴파일된 헤더를 사용하지 않음
+#include "ShmChannel.h"
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/interprocess_semaphore.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace ipc = boost::interprocess;
+
+namespace {
+
+    const uint32_t SHM_MAGIC = 0x4D464253; // "MFBS"
+    const uint32_t SHM_VERSION = 1;
+    const size_t LISTEN_QUEUE_SIZE = 128; // 서버가 아직 받지 않은 연결 요청 수 (listen 백로그)
+    const size_t SEGMENT_NAME_SIZE = 96;
+    const size_t MAX_NAME_LENGTH = 32;
+    const std::string NAME_PREFIX = "mfcboost.";
+
+    uint32_t currentProcessId() {
+#ifdef _WIN32
+        return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+        return static_cast<uint32_t>(getpid());
+#endif
+    }
+
+    // 닫지 않고 종료된 상대를 찾기 위한 확인
+    bool isProcessAlive(uint32_t pid) {
+#ifdef _WIN32
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+        if (!process) {
+            return false;
+        }
+        bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return alive;
+#else
+        return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+    }
+
+    // 공유 메모리 이름에 쓸 수 있는 이름인지 (영문, 숫자, -, _)
+    bool isValidName(const std::string& name) {
+
+        if (name.empty() || name.size() > MAX_NAME_LENGTH) {
+            return false;
+        }
+        return std::all_of(name.begin(), name.end(), [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+            });
+    }
+
+    // 세마포어 대기 기한 (interprocess 는 UTC 절대 시각을 받음)
+    boost::posix_time::ptime deadlineAfter(int ms) {
+        return boost::posix_time::microsec_clock::universal_time() + boost::posix_time::milliseconds(ms);
+    }
+}
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "공유 메모리의 원자 변수는 잠금 없이 동작해야 함");
+
+// 방향 하나의 링 버퍼 (head, tail 은 계속 늘어나는 바이트 수, 위치는 RING_SIZE 로 나눈 나머지)
+struct ShmRing {
+    ShmRing() : head(0), tail(0), reader_waiting(0), writer_waiting(0), readable(0), writable(0) {}
+
+    alignas(64) std::atomic<uint64_t> head; // 생산자가 쓴 바이트
+    alignas(64) std::atomic<uint64_t> tail; // 소비자가 읽은 바이트
+    alignas(64) std::atomic<uint32_t> reader_waiting; // 소비자가 readable 에서 기다리는 중 (생산자가 보고 깨움)
+    std::atomic<uint32_t> writer_waiting; // 생산자가 writable 에서 기다리는 중 (소비자가 보고 깨움)
+    ipc::interprocess_semaphore readable;
+    ipc::interprocess_semaphore writable;
+    alignas(64) char data[ShmChannel::RING_SIZE];
+};
+
+// 연결 하나의 공유 메모리 (클라이언트가 만들고 서버가 엶)
+struct ShmConnectionBlock {
+    ShmConnectionBlock() : magic(SHM_MAGIC), version(SHM_VERSION), accepted(0) {
+        for (int side = 0; side < 2; ++side) {
+            pid[side].store(0);
+            closed[side].store(0);
+        }
+    }
+
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> pid[2]; // 0 클라이언트, 1 서버
+    std::atomic<uint32_t> closed[2]; // 닫은 쪽 (남은 데이터를 다 읽으면 eof)
+    ipc::interprocess_semaphore accepted; // 서버가 연결을 받으면 post
+    ShmRing rings[2]; // 0: 클라이언트 -> 서버, 1: 서버 -> 클라이언트
+};
+
+// 서버의 연결 요청 대기열
+struct ShmListenerBlock {
+    ShmListenerBlock() : magic(SHM_MAGIC), version(SHM_VERSION), pid(currentProcessId()), pending(0), head(0), tail(0) {}
+
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> pid; // 서버 프로세스
+    ipc::interprocess_mutex mutex; // 대기열 보호
+    ipc::interprocess_semaphore pending; // 대기열의 요청 수
+    uint32_t head; // 서버가 꺼낸 요청 수
+    uint32_t tail; // 클라이언트가 넣은 요청 수
+    char segments[LISTEN_QUEUE_SIZE][SEGMENT_NAME_SIZE]; // 연결 공유 메모리 이름
+};
+
+// 생성자
+std::shared_ptr<ShmChannel> ShmChannel::create(boost::asio::io_context& io_context) {
+    return std::shared_ptr<ShmChannel>(new ShmChannel(io_context));
+}
+
+// 생성자
+ShmChannel::ShmChannel(boost::asio::io_context& io_context) : io_context_(io_context),
+    block_(nullptr),
+    in_(nullptr),
+    out_(nullptr),
+    side_(0),
+    closed_(false) {
+
+    reader_.thread = std::thread(&ShmChannel::runWorker, this, std::ref(reader_));
+    writer_.thread = std::thread(&ShmChannel::runWorker, this, std::ref(writer_));
+}
+
+// 소멸자
+ShmChannel::~ShmChannel() {
+
+    close();
+
+    for (Worker* worker : { &reader_, &writer_ }) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stop = true;
+        }
+        worker->condition.notify_one();
+        worker->thread.join();
+    }
+
+    // 연결 전에 실패했거나 이름을 지우지 못했으면 여기서 지움
+    if (!segment_.empty()) {
+        ipc::shared_memory_object::remove(segment_.c_str());
+    }
+}
+
+// 서버에 연결
+void ShmChannel::asyncConnect(const std::string& name, std::function<void(const boost::system::error_code&)> handler) {
+
+    auto fail = [this, handler](const boost::system::error_code& ec) {
+        boost::asio::post(io_context_, [handler, ec]() { handler(ec); });
+    };
+
+    if (!isValidName(name)) {
+        fail(boost::asio::error::invalid_argument);
+        return;
+    }
+
+    static std::atomic<uint32_t> connection_count(0);
+
+    ShmConnectionBlock* block = nullptr;
+    try {
+        ipc::shared_memory_object listener_shm(ipc::open_only, (NAME_PREFIX + name).c_str(), ipc::read_write);
+        ipc::mapped_region listener_region(listener_shm, ipc::read_write);
+        ShmListenerBlock* listener = static_cast<ShmListenerBlock*>(listener_region.get_address());
+
+        if (listener_region.get_size() < sizeof(ShmListenerBlock) || listener->magic != SHM_MAGIC || listener->version != SHM_VERSION || !isProcessAlive(listener->pid)) {
+            fail(boost::asio::error::connection_refused);
+            return;
+        }
+
+        // 연결용 공유 메모리를 만들어 서버 대기열에 이름을 넣음
+        segment_ = NAME_PREFIX + name + "." + std::to_string(currentProcessId()) + "." + std::to_string(++connection_count);
+        ipc::shared_memory_object::remove(segment_.c_str());
+        ipc::shared_memory_object shm(ipc::create_only, segment_.c_str(), ipc::read_write);
+        shm.truncate(sizeof(ShmConnectionBlock));
+        region_.reset(new ipc::mapped_region(shm, ipc::read_write));
+        block = new (region_->get_address()) ShmConnectionBlock();
+        block->pid[0] = currentProcessId();
+
+        {
+            ipc::scoped_lock<ipc::interprocess_mutex> lock(listener->mutex);
+            if (listener->tail - listener->head >= LISTEN_QUEUE_SIZE) {
+                fail(boost::asio::error::connection_refused);
+                return;
+            }
+            char* slot = listener->segments[listener->tail % LISTEN_QUEUE_SIZE];
+            strncpy(slot, segment_.c_str(), SEGMENT_NAME_SIZE - 1);
+            slot[SEGMENT_NAME_SIZE - 1] = '\0';
+            listener->tail++;
+        }
+        listener->pending.post();
+    }
+    catch (const ipc::interprocess_exception&) {
+        fail(boost::asio::error::connection_refused);
+        return;
+    }
+
+    // 서버가 받을 때까지는 대기 스레드에서 기다리고, 결과는 io 스레드에서 반영
+    std::weak_ptr<ShmChannel> weak_self = shared_from_this();
+    submit(reader_, [this, weak_self, block, handler]() mutable {
+
+        bool accepted = block->accepted.timed_wait(deadlineAfter(CONNECT_TIMEOUT_MS));
+
+        // 양쪽이 매핑한 뒤에는 이름이 필요 없음 (실패하면 소멸자에서 다시 지움)
+        if (ipc::shared_memory_object::remove(segment_.c_str())) {
+            segment_.clear();
+        }
+
+        // 핸들러는 옮겨 감 (마지막 참조가 대기 스레드에서 풀리면 소멸자가 자기 스레드를 join 하게 됨)
+        boost::asio::post(io_context_, [weak_self, block, done = std::move(handler), accepted]() {
+
+            auto self = weak_self.lock();
+            if (!self) {
+                done(boost::asio::error::operation_aborted);
+                return;
+            }
+
+            boost::system::error_code ec;
+            if (!accepted || self->closed_) {
+                block->closed[0] = 1; // 늦게 받은 서버는 바로 eof
+                ec = self->closed_ ? boost::asio::error::operation_aborted : boost::asio::error::timed_out;
+            }
+            else {
+                self->attach(block, 0);
+            }
+            done(ec);
+            });
+        handler = nullptr;
+        });
+}
+
+// 연결 요청으로 받은 공유 메모리 열기
+bool ShmChannel::accept(const std::string& segment) {
+
+    try {
+        ipc::shared_memory_object shm(ipc::open_only, segment.c_str(), ipc::read_write);
+        region_.reset(new ipc::mapped_region(shm, ipc::read_write));
+    }
+    catch (const ipc::interprocess_exception&) {
+        return false;
+    }
+
+    ShmConnectionBlock* block = static_cast<ShmConnectionBlock*>(region_->get_address());
+    if (region_->get_size() < sizeof(ShmConnectionBlock) || block->magic != SHM_MAGIC || block->version != SHM_VERSION) {
+        return false;
+    }
+
+    block->pid[1] = currentProcessId();
+    attach(block, 1);
+    block->accepted.post();
+    return true;
+}
+
+// 연결한 공유 메모리 사용 시작
+void ShmChannel::attach(ShmConnectionBlock* block, int side) {
+
+    side_ = side;
+    out_ = &block->rings[side];
+    in_ = &block->rings[1 - side];
+    block_ = block;
+}
+
+// 버퍼를 다 채울 때까지 읽기
+void ShmChannel::asyncRead(const std::vector<boost::asio::mutable_buffer>& buffers, Handler handler) {
+
+    auto op = std::make_shared<Operation>();
+    for (const auto& buffer : buffers) {
+        if (buffer.size() > 0) {
+            op->buffers.emplace_back(static_cast<char*>(buffer.data()), buffer.size());
+        }
+    }
+    op->handler = std::move(handler);
+
+    if (!isOpen()) {
+        complete(op->handler, boost::asio::error::operation_aborted, 0);
+        return;
+    }
+
+    // 이미 도착한 데이터로 끝나면 대기 스레드를 거치지 않음
+    if (progressRead(*op)) {
+        complete(op->handler, boost::system::error_code(), op->transferred);
+        return;
+    }
+
+    submit(reader_, [this, op]() { finishRead(op); });
+}
+
+// 버퍼를 다 보낼 때까지 쓰기
+void ShmChannel::asyncWrite(const std::vector<boost::asio::const_buffer>& buffers, Handler handler) {
+
+    auto op = std::make_shared<Operation>();
+    for (const auto& buffer : buffers) {
+        if (buffer.size() > 0) {
+            op->buffers.emplace_back(const_cast<char*>(static_cast<const char*>(buffer.data())), buffer.size());
+        }
+    }
+    op->handler = std::move(handler);
+
+    if (!isOpen()) {
+        complete(op->handler, boost::asio::error::operation_aborted, 0);
+        return;
+    }
+
+    bool failed = false;
+    if (progressWrite(*op, failed)) {
+        complete(op->handler, boost::system::error_code(), op->transferred);
+        return;
+    }
+
+    submit(writer_, [this, op]() { finishWrite(op); });
+}
+
+// 링에 직접 채워 보냄
+void ShmChannel::asyncWriteFrom(std::size_t length, Filler filler, Handler handler) {
+
+    auto op = std::make_shared<Operation>();
+    op->filler = std::move(filler);
+    op->fill_length = length;
+    op->handler = std::move(handler);
+
+    if (!isOpen()) {
+        complete(op->handler, boost::asio::error::operation_aborted, 0);
+        return;
+    }
+
+    bool failed = false;
+    if (progressWrite(*op, failed) || failed) {
+        complete(op->handler, failed ? boost::asio::error::fault : boost::system::error_code(), op->transferred);
+        return;
+    }
+
+    submit(writer_, [this, op]() { finishWrite(op); });
+}
+
+// 연결 종료
+void ShmChannel::close() {
+
+    if (closed_.exchange(true)) {
+        return;
+    }
+
+    // 서버가 받기를 기다리는 중이면 대기 스레드를 깨움
+    if (!block_) {
+        if (region_ && side_ == 0) {
+            static_cast<ShmConnectionBlock*>(region_->get_address())->accepted.post();
+        }
+        return;
+    }
+
+    block_->closed[side_] = 1;
+
+    // 기다리는 내 대기 스레드와 상대를 모두 깨움
+    in_->readable.post();
+    in_->writable.post();
+    out_->readable.post();
+    out_->writable.post();
+}
+
+bool ShmChannel::isOpen() const {
+    return block_ != nullptr && !closed_;
+}
+
+// 서버가 이 이름으로 연결을 받고 있는지
+bool ShmChannel::listenerExists(const std::string& name) {
+
+    if (!isValidName(name)) {
+        return false;
+    }
+
+    try {
+        ipc::shared_memory_object shm(ipc::open_only, (NAME_PREFIX + name).c_str(), ipc::read_only);
+        ipc::mapped_region region(shm, ipc::read_only);
+        const ShmListenerBlock* listener = static_cast<const ShmListenerBlock*>(region.get_address());
+        return region.get_size() >= sizeof(ShmListenerBlock) && listener->magic == SHM_MAGIC && listener->version == SHM_VERSION && isProcessAlive(listener->pid);
+    }
+    catch (const ipc::interprocess_exception&) {
+        return false;
+    }
+}
+
+// 대기 스레드 루프
+void ShmChannel::runWorker(Worker& worker) {
+
+    for (;;) {
+
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.condition.wait(lock, [&worker]() { return worker.stop || worker.task; });
+            if (!worker.task) {
+                return;
+            }
+            task.swap(worker.task);
+        }
+
+        task();
+    }
+}
+
+// 대기 스레드에 작업 넘기기
+void ShmChannel::submit(Worker& worker, std::function<void()> task) {
+
+    // 소켓의 비동기 작업처럼 끝날 때까지 io_context 가 멈추지 않도록 붙잡음
+    auto work = std::make_shared<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>(io_context_.get_executor());
+
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.task = [task, work]() {
+            task();
+            work->reset();
+        };
+    }
+    worker.condition.notify_one();
+}
+
+// 읽을 수 있는 만큼 복사
+bool ShmChannel::progressRead(Operation& op) {
+
+    uint64_t tail = in_->tail.load(std::memory_order_relaxed);
+    uint64_t head = in_->head.load(std::memory_order_acquire);
+    bool copied = false;
+
+    while (op.index < op.buffers.size() && head != tail) {
+
+        std::pair<char*, std::size_t>& buffer = op.buffers[op.index];
+        std::size_t position = static_cast<std::size_t>(tail % RING_SIZE);
+        std::size_t length = (std::min)({ static_cast<std::size_t>(head - tail), buffer.second - op.offset, RING_SIZE - position });
+
+        memcpy(buffer.first + op.offset, in_->data + position, length);
+        tail += length;
+        op.offset += length;
+        op.transferred += length;
+        copied = true;
+
+        if (op.offset == buffer.second) {
+            op.index++;
+            op.offset = 0;
+        }
+    }
+
+    // 생산자가 빈 공간을 기다리고 있으면 깨움
+    if (copied) {
+        in_->tail.store(tail);
+        if (in_->writer_waiting.exchange(0)) {
+            in_->writable.post();
+        }
+    }
+
+    return op.index == op.buffers.size();
+}
+
+// 쓸 수 있는 만큼 복사
+bool ShmChannel::progressWrite(Operation& op, bool& failed) {
+
+    uint64_t head = out_->head.load(std::memory_order_relaxed);
+    uint64_t tail = out_->tail.load(std::memory_order_acquire);
+    bool copied = false;
+
+    if (op.filler) {
+
+        while (op.transferred < op.fill_length && head - tail < RING_SIZE) {
+
+            std::size_t position = static_cast<std::size_t>(head % RING_SIZE);
+            std::size_t length = (std::min)({ op.fill_length - op.transferred, static_cast<std::size_t>(RING_SIZE - (head - tail)), RING_SIZE - position });
+
+            if (!op.filler(out_->data + position, length, op.transferred)) {
+                failed = true;
+                break;
+            }
+            head += length;
+            op.transferred += length;
+            copied = true;
+        }
+    }
+    else {
+
+        while (op.index < op.buffers.size() && head - tail < RING_SIZE) {
+
+            std::pair<char*, std::size_t>& buffer = op.buffers[op.index];
+            std::size_t position = static_cast<std::size_t>(head % RING_SIZE);
+            std::size_t length = (std::min)({ buffer.second - op.offset, static_cast<std::size_t>(RING_SIZE - (head - tail)), RING_SIZE - position });
+
+            memcpy(out_->data + position, buffer.first + op.offset, length);
+            head += length;
+            op.offset += length;
+            op.transferred += length;
+            copied = true;
+
+            if (op.offset == buffer.second) {
+                op.index++;
+                op.offset = 0;
+            }
+        }
+    }
+
+    // 소비자가 데이터를 기다리고 있으면 깨움
+    if (copied) {
+        out_->head.store(head);
+        if (out_->reader_waiting.exchange(0)) {
+            out_->readable.post();
+        }
+    }
+
+    return op.filler ? op.transferred == op.fill_length : op.index == op.buffers.size();
+}
+
+// 읽기를 끝까지 진행
+void ShmChannel::finishRead(std::shared_ptr<Operation> op) {
+
+    for (;;) {
+
+        if (progressRead(*op)) {
+            complete(op->handler, boost::system::error_code(), op->transferred);
+            return;
+        }
+
+        boost::system::error_code ec = waitReadable();
+        if (ec) {
+            complete(op->handler, ec, op->transferred);
+            return;
+        }
+    }
+}
+
+// 쓰기를 끝까지 진행
+void ShmChannel::finishWrite(std::shared_ptr<Operation> op) {
+
+    for (;;) {
+
+        bool failed = false;
+        if (progressWrite(*op, failed)) {
+            complete(op->handler, boost::system::error_code(), op->transferred);
+            return;
+        }
+        if (failed) {
+            complete(op->handler, boost::asio::error::fault, op->transferred);
+            return;
+        }
+
+        boost::system::error_code ec = waitWritable();
+        if (ec) {
+            complete(op->handler, ec, op->transferred);
+            return;
+        }
+    }
+}
+
+// 데이터가 올 때까지 대기 (오류가 없으면 다시 읽어 봄)
+boost::system::error_code ShmChannel::waitReadable() {
+
+    if (closed_) {
+        return boost::asio::error::operation_aborted;
+    }
+
+    // 플래그를 세운 뒤 다시 확인해야 생산자의 깨우기를 놓치지 않음
+    // 상대는 데이터를 다 쓴 뒤에 닫으므로 닫힘을 먼저 읽고 데이터를 확인하면 남은 데이터를 놓치지 않음
+    in_->reader_waiting.store(1);
+    bool peer_closed = block_->closed[1 - side_] != 0;
+    if (in_->head.load() != in_->tail.load(std::memory_order_relaxed)) {
+        in_->reader_waiting.store(0);
+        return boost::system::error_code();
+    }
+    if (peer_closed) {
+        in_->reader_waiting.store(0);
+        return boost::asio::error::eof;
+    }
+
+    bool woken = in_->readable.timed_wait(deadlineAfter(LIVENESS_CHECK_MS));
+    in_->reader_waiting.store(0);
+
+    if (!woken && peerGone()) {
+        return boost::asio::error::connection_reset;
+    }
+    return boost::system::error_code();
+}
+
+// 빈 공간이 생길 때까지 대기 (오류가 없으면 다시 써 봄)
+boost::system::error_code ShmChannel::waitWritable() {
+
+    if (closed_) {
+        return boost::asio::error::operation_aborted;
+    }
+
+    out_->writer_waiting.store(1);
+    if (block_->closed[1 - side_] != 0) {
+        out_->writer_waiting.store(0);
+        return boost::asio::error::broken_pipe;
+    }
+    if (out_->head.load(std::memory_order_relaxed) - out_->tail.load() < RING_SIZE) {
+        out_->writer_waiting.store(0);
+        return boost::system::error_code();
+    }
+
+    bool woken = out_->writable.timed_wait(deadlineAfter(LIVENESS_CHECK_MS));
+    out_->writer_waiting.store(0);
+
+    if (!woken && peerGone()) {
+        return boost::asio::error::connection_reset;
+    }
+    return boost::system::error_code();
+}
+
+// 완료 핸들러를 io_context 에서 호출
+void ShmChannel::complete(Handler& handler, const boost::system::error_code& ec, std::size_t transferred) {
+
+    boost::asio::post(io_context_, [done = std::move(handler), ec, transferred]() { done(ec, transferred); });
+    handler = nullptr;
+}
+
+// 상대 프로세스가 닫지 않고 종료되었는지
+bool ShmChannel::peerGone() const {
+
+    uint32_t pid = block_->pid[1 - side_];
+    return pid != 0 && !isProcessAlive(pid);
+}
+
+// 생성자 (같은 이름의 이전 대기열은 지우고 새로 만듦)
+ShmListener::ShmListener(const std::string& name) : name_(NAME_PREFIX + name), block_(nullptr) {
+
+    if (!isValidName(name)) {
+        throw std::invalid_argument("공유 메모리 이름은 영문, 숫자, -, _ 로 " + std::to_string(MAX_NAME_LENGTH) + "자까지 사용할 수 있습니다: " + name);
+    }
+
+    ipc::shared_memory_object::remove(name_.c_str());
+    ipc::shared_memory_object shm(ipc::create_only, name_.c_str(), ipc::read_write);
+    shm.truncate(sizeof(ShmListenerBlock));
+    region_.reset(new ipc::mapped_region(shm, ipc::read_write));
+    block_ = new (region_->get_address()) ShmListenerBlock();
+}
+
+// 소멸자
+ShmListener::~ShmListener() {
+
+    block_->pid = 0;
+    ipc::shared_memory_object::remove(name_.c_str());
+}
+
+// 다음 연결 요청
+bool ShmListener::waitForConnection(std::string& segment, int timeout_ms) {
+
+    if (!block_->pending.timed_wait(deadlineAfter(timeout_ms))) {
+        return false;
+    }
+
+    ipc::scoped_lock<ipc::interprocess_mutex> lock(block_->mutex);
+    if (block_->head == block_->tail) {
+        return false;
+    }
+
+    const char* slot = block_->segments[block_->head % LISTEN_QUEUE_SIZE];
+    segment.assign(slot, strnlen(slot, SEGMENT_NAME_SIZE));
+    block_->head++;
+    return true;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <boost/asio.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ShmConnectionBlock;
+struct ShmListenerBlock;
+struct ShmRing;
+
+// 같은 컴퓨터의 클라이언트와 서버를 잇는 공유 메모리 연결 (접속 주소 "shm://이름", 클라이언트와 C++ 서버가 함께 사용)
+// 연결마다 공유 메모리 하나에 방향별 단일 생산자/단일 소비자 링 버퍼를 두고, TCP 와 같은 길이 + 플래그 프레임을 그대로 실음
+// 상대가 기다리고 있을 때만 프로세스 간 세마포어로 깨움 (리눅스에서는 futex 기반)
+//
+// 읽기/쓰기는 asio 의 async_read/async_write 처럼 버퍼를 다 채우거나 다 보낸 뒤 io_context 에서 완료 핸들러를 호출
+// 바로 끝낼 수 있으면 호출한 스레드에서 복사하고, 기다려야 하면 방향마다 하나인 대기 스레드가 마저 처리
+// 방향마다 진행 중인 작업은 하나만 허용 (async_write 를 겹쳐 부르지 않는 것과 같음)
+class ShmChannel : public std::enable_shared_from_this<ShmChannel> {
+public:
+    typedef std::function<void(const boost::system::error_code&, std::size_t)> Handler;
+
+    // 링에 직접 채우기 (dest 에 length 바이트, position 은 보낼 데이터 안의 위치, 실패하면 false)
+    typedef std::function<bool(char* dest, std::size_t length, std::size_t position)> Filler;
+
+    // 생성자
+    static std::shared_ptr<ShmChannel> create(boost::asio::io_context& io_context);
+    ~ShmChannel();
+
+    // 클라이언트: 이름으로 연결을 받는 서버에 연결 (handler 는 io_context 에서 호출)
+    void asyncConnect(const std::string& name, std::function<void(const boost::system::error_code&)> handler);
+
+    // 서버: 연결 요청으로 받은 공유 메모리 열기
+    bool accept(const std::string& segment);
+
+    // 버퍼를 다 채울 때까지 읽기
+    void asyncRead(const std::vector<boost::asio::mutable_buffer>& buffers, Handler handler);
+
+    // 버퍼를 다 보낼 때까지 쓰기
+    void asyncWrite(const std::vector<boost::asio::const_buffer>& buffers, Handler handler);
+
+    // 링에 직접 length 바이트를 채워 보냄 (서버가 파일을 중간 버퍼 없이 링으로 읽을 때)
+    void asyncWriteFrom(std::size_t length, Filler filler, Handler handler);
+
+    // 연결 종료 (진행 중인 작업은 operation_aborted 로 끝나고, 상대는 남은 데이터를 읽은 뒤 eof)
+    void close();
+
+    bool isOpen() const;
+
+    // 서버가 이 이름으로 연결을 받고 있는지
+    static bool listenerExists(const std::string& name);
+
+    static const std::size_t RING_SIZE = 4 * 1024 * 1024; // 방향별 링 크기
+    static const int CONNECT_TIMEOUT_MS = 3000; // 서버가 연결을 받을 때까지 기다리는 시간
+    static const int LIVENESS_CHECK_MS = 200; // 기다리는 동안 닫힘과 상대 프로세스 종료를 확인하는 주기
+
+private:
+    // 대기 스레드 하나 (받은 작업을 차례로 실행)
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::function<void()> task;
+        bool stop = false;
+    };
+
+    // 진행 중인 읽기/쓰기
+    struct Operation {
+        std::vector<std::pair<char*, std::size_t>> buffers; // 쓰기면 읽기만 함
+        Filler filler; // asyncWriteFrom 이면 buffers 대신 사용
+        std::size_t fill_length = 0;
+        std::size_t index = 0; // 현재 버퍼
+        std::size_t offset = 0; // 현재 버퍼 안의 위치
+        std::size_t transferred = 0;
+        Handler handler;
+    };
+
+    // 생성자 (private)
+    explicit ShmChannel(boost::asio::io_context& io_context);
+
+    // 연결한 공유 메모리 사용 시작 (side 0 클라이언트, 1 서버)
+    void attach(ShmConnectionBlock* block, int side);
+
+    // 대기 스레드 루프
+    void runWorker(Worker& worker);
+
+    // 대기 스레드에 작업 넘기기
+    void submit(Worker& worker, std::function<void()> task);
+
+    // 읽을 수 있는 만큼 복사 (다 채웠으면 true)
+    bool progressRead(Operation& op);
+
+    // 쓸 수 있는 만큼 복사 (다 보냈으면 true, 채우기 실패는 failed)
+    bool progressWrite(Operation& op, bool& failed);
+
+    // 작업을 끝까지 진행 (대기 스레드에서 호출)
+    void finishRead(std::shared_ptr<Operation> op);
+    void finishWrite(std::shared_ptr<Operation> op);
+
+    // 링이 비었거나 가득 찼을 때 상대가 깨울 때까지 대기 (닫혔거나 상대가 없어졌으면 오류)
+    boost::system::error_code waitReadable();
+    boost::system::error_code waitWritable();
+
+    // 완료 핸들러를 io_context 에서 호출 (핸들러는 옮겨 가므로 대기 스레드에 사용자 객체의 참조가 남지 않음)
+    void complete(Handler& handler, const boost::system::error_code& ec, std::size_t transferred);
+
+    // 상대 프로세스가 닫지 않고 종료되었는지
+    bool peerGone() const;
+
+    boost::asio::io_context& io_context_;
+    std::unique_ptr<boost::interprocess::mapped_region> region_;
+    ShmConnectionBlock* block_;
+    ShmRing* in_; // 상대 -> 나
+    ShmRing* out_; // 나 -> 상대
+    int side_;
+    std::string segment_; // 공유 메모리 이름 (클라이언트가 만들고 연결 후 지움)
+    std::atomic<bool> closed_;
+    Worker reader_;
+    Worker writer_;
+};
+
+// 서버: "shm://이름" 연결 요청 받기 (이름별 공유 메모리에 요청 대기열을 둠)
+class ShmListener {
+public:
+    explicit ShmListener(const std::string& name);
+    ~ShmListener();
+
+    // 다음 연결 요청의 공유 메모리 이름 (timeout 안에 요청이 없으면 false)
+    bool waitForConnection(std::string& segment, int timeout_ms);
+
+private:
+    std::string name_;
+    std::unique_ptr<boost::interprocess::mapped_region> region_;
+    ShmListenerBlock* block_;
+};
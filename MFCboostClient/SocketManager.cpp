@@ -1,46 +1,227 @@
 #include "pch.h"
 #include "SocketManager.h"
+#include "Crc32c.h"
 #include <boost/bind/bind.hpp>
 #include <boost/endian/conversion.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <thread>
 
-// 
+namespace {
+    const std::string TLS_SCHEME = "tls://";
+    const std::string SHM_SCHEME = "shm://";
+}
+
+// 생성자
 std::shared_ptr<SocketManager> SocketManager::create(boost::asio::io_context& io_context) {
     return std::shared_ptr<SocketManager>(new SocketManager(io_context));
 }
 
-// 
+// 생성자
 SocketManager::SocketManager(boost::asio::io_context& io_context) : io_context_(io_context),
     socket_(io_context),
+    tls_context_(boost::asio::ssl::context::tls_client),
+    tls_session_(nullptr),
+    tls_enabled_(false),
+    max_transfers_(1),
     heartbeat_timer_(io_context),
     reconnect_timer_(io_context),
+    pipeline_timer_(io_context),
+    last_upload_id_(0),
+    write_in_progress_(false),
+    write_scheduled_(false),
     connected_(false),
-    reconnect_attempts_(0) {}
+    reconnect_attempts_(0),
+    message_flags_(0),
+    slice_frame_size_(0),
+    slice_offset_(0),
+    compression_enabled_(false),
+    stripes_supported_(false),
+    uploads_supported_(false),
+    binary_control_enabled_(false),
+    raw_bytes_sent_(0),
+    wire_bytes_sent_(0),
+    raw_bytes_received_(0),
+    wire_bytes_received_(0),
+    compress_time_us_(0),
+    decompress_time_us_(0),
+    receive_busy_us_(0),
+    recording_(false),
+    current_port_(0),
+    active_endpoint_(0),
+    endpoint_selected_(false),
+    degraded_rounds_(0),
+    connect_started_(0) {
 
-// Ҹ
+    tls_context_.set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_tlsv1 | boost::asio::ssl::context::no_tlsv1_1);
+    tls_context_.set_default_verify_paths();
+    tls_context_.set_verify_mode(boost::asio::ssl::verify_peer);
+
+    // 세션 티켓을 클라이언트 쪽에 캐시해서 재연결 시 전체 핸드셰이크 생략
+    SSL_CTX_set_session_cache_mode(tls_context_.native_handle(), SSL_SESS_CACHE_CLIENT);
+}
+
+// 소멸자
 SocketManager::~SocketManager() {
     disconnect();
+
+    if (tls_session_) {
+        SSL_SESSION_free(tls_session_);
+    }
 }
 
-//  
+// TLS 서버 인증서 검증에 사용할 CA 파일
+void SocketManager::setTlsCaFile(const std::string& ca_file) {
+
+    boost::system::error_code ec;
+    tls_context_.load_verify_file(ca_file, ec);
+    if (ec) {
+        std::cerr << "CA 파일 로드 실패: " << ec.message() << std::endl;
+    }
+}
+
+// 동시에 받을 수 있는 파일 수
+void SocketManager::setMaxTransfers(size_t max_transfers) {
+    max_transfers_ = max_transfers > 0 ? max_transfers : 1;
+}
+
+// 서버에 연결
 void SocketManager::connect(const std::string& host, int port) {
+    connect(std::vector<ServerEndpoint>{ { host, port } });
+}
+
+// 여러 서버 중 가장 빠른 정상 서버에 연결
+void SocketManager::connect(const std::vector<ServerEndpoint>& endpoints) {
+
+    // 서버 목록, 모니터, 연결 상태는 프로브와 재연결 처리가 도는 io 스레드에서만 바꿈
+    auto self(shared_from_this());
+    boost::asio::post(io_context_, [this, self, endpoints]() {
+        startConnect(endpoints);
+        });
+}
+
+// 서버 목록 교체 후 연결 시작 (io 스레드)
+void SocketManager::startConnect(const std::vector<ServerEndpoint>& endpoints) {
 
     if (connected_) {
-        std::cout << "̹ Ǿ ֽϴ.   մϴ." << std::endl;
-        disconnect();
+        std::cout << "이미 연결되어 있습니다. 먼저 연결을 종료합니다." << std::endl;
+    }
+    disconnect();
+
+    if (endpoints.empty()) {
+        return;
+    }
+
+    endpoints_ = endpoints;
+    active_endpoint_ = 0;
+    degraded_rounds_ = 0;
+    reconnect_attempts_ = 0;
+
+    if (endpoints_.size() == 1) {
+        connectEndpoint(0);
+        return;
+    }
+
+    // 첫 프로브 라운드가 끝나면 서버를 고름
+    endpoint_selected_ = false;
+    endpoint_monitor_ = EndpointMonitor::create(io_context_, endpoints_);
+
+    // 이전 연결의 모니터가 멈추기 전에 끝낸 라운드는 무시
+    std::weak_ptr<SocketManager> weak_self = shared_from_this();
+    EndpointMonitor* monitor = endpoint_monitor_.get();
+    endpoint_monitor_->setOnRoundListener([weak_self, monitor]() {
+        auto self = weak_self.lock();
+        if (self && self->endpoint_monitor_.get() == monitor) {
+            self->handleProbeRound();
+        }
+        });
+
+    std::cout << "서버 " << endpoints_.size() << "개의 왕복 시간 측정 중..." << std::endl;
+    endpoint_monitor_->start();
+}
+
+// 연결 중이거나 마지막으로 연결을 시도한 서버
+ServerEndpoint SocketManager::getActiveEndpoint() const {
+    return ServerEndpoint{ current_host_, current_port_ };
+}
+
+// 서버별 왕복 시간과 상태
+std::vector<EndpointHealth> SocketManager::getEndpointHealth() const {
+    return endpoint_monitor_ ? endpoint_monitor_->getHealth() : std::vector<EndpointHealth>();
+}
+
+// 목록의 서버에 연결
+void SocketManager::connectEndpoint(size_t index) {
+
+    const ServerEndpoint& endpoint = endpoints_[index];
+
+    // 다른 서버의 TLS 세션은 재사용할 수 없음
+    if (tls_session_ && endpoint.host != current_host_) {
+        SSL_SESSION_free(tls_session_);
+        tls_session_ = nullptr;
+    }
+
+    // 실패한 이전 공유 메모리 연결 정리
+    if (shm_channel_) {
+        shm_channel_->close();
+        shm_channel_.reset();
+    }
+
+    active_endpoint_ = index;
+    current_host_ = endpoint.host;
+    current_port_ = endpoint.port;
+
+    // "shm://이름" 형식이면 같은 컴퓨터의 서버에 공유 메모리로 연결 (포트는 사용하지 않음)
+    if (current_host_.compare(0, SHM_SCHEME.size(), SHM_SCHEME) == 0) {
+
+        tls_enabled_ = false;
+        std::cout << "서버에 연결 시도: " << current_host_ << std::endl;
+
+        connect_started_ = Profiler::begin();
+        connect_time_ = std::chrono::steady_clock::now();
+        shm_channel_ = ShmChannel::create(io_context_);
+
+        // 그사이 연결을 닫고 새로 연결했으면 이전 연결의 결과는 무시
+        auto self(shared_from_this());
+        ShmChannel* channel = shm_channel_.get();
+        shm_channel_->asyncConnect(current_host_.substr(SHM_SCHEME.size()), [this, self, channel](const boost::system::error_code& ec) {
+            if (shm_channel_.get() == channel) {
+                handleConnect(ec, boost::asio::ip::tcp::endpoint());
+            }
+            });
+        return;
     }
 
-    current_host_ = host;
-    current_port_ = port;
+    // "tls://host" 형식이면 TLS 사용
+    std::string address = current_host_;
+    tls_enabled_ = address.compare(0, TLS_SCHEME.size(), TLS_SCHEME) == 0;
+    if (tls_enabled_) {
+        address = address.substr(TLS_SCHEME.size());
+    }
 
+    // 주소를 확인할 수 없는 서버는 실패로 표시하고 다른 서버로 (io 스레드 밖으로 예외를 던지지 않음)
+    boost::system::error_code resolve_ec;
     boost::asio::ip::tcp::resolver resolver(io_context_);
-    auto endpoints = resolver.resolve(host, std::to_string(port));
+    auto endpoints = resolver.resolve(address, std::to_string(current_port_), resolve_ec);
+    if (resolve_ec) {
 
-    std::cout << "  õ: " << host << ":" << port << std::endl;
+        std::cerr << "서버 주소 확인 실패: " << current_host_ << " (" << resolve_ec.message() << ")" << std::endl;
+        if (endpoint_monitor_) {
+            endpoint_monitor_->markFailed(index);
+        }
+        handleReconnect();
+        return;
+    }
+
+    std::cout << "서버에 연결 시도: " << current_host_ << ":" << current_port_ << std::endl;
 
+    connect_started_ = Profiler::begin();
+    connect_time_ = std::chrono::steady_clock::now();
     doConnect(endpoints);
 }
 
-// 񵿱  ó
+// 비동기 연결 처리
 void SocketManager::doConnect(const boost::asio::ip::tcp::resolver::results_type& endpoints) {
     boost::asio::async_connect(socket_, endpoints,
         boost::bind(&SocketManager::handleConnect, shared_from_this(),
@@ -48,200 +229,1013 @@ void SocketManager::doConnect(const boost::asio::ip::tcp::resolver::results_type
             boost::asio::placeholders::endpoint));
 }
 
-//  ó
+// 연결 처리
 void SocketManager::handleConnect(const boost::system::error_code& error, const boost::asio::ip::tcp::endpoint& endpoint) {
     if (!error) {
 
-        connected_ = true;
-        reconnect_attempts_ = 0;
-        if (on_connect_) on_connect_();
-        
-        std::cout << " Ǿϴ." << std::endl;
+        if (!tls_enabled_) {
+            tls_stream_.reset();
+            handleTransportReady();
+            return;
+        }
+
+        // SSL 객체는 재사용할 수 없으므로 연결마다 새로 생성
+        tls_stream_.reset(new boost::asio::ssl::stream<boost::asio::ip::tcp::socket&>(socket_, tls_context_));
 
-        doRead();
-        startHeartbeat();
+        std::string server_name = current_host_.substr(TLS_SCHEME.size());
+        SSL_set_tlsext_host_name(tls_stream_->native_handle(), server_name.c_str());
+        tls_stream_->set_verify_callback(boost::asio::ssl::host_name_verification(server_name));
+
+        if (tls_session_) {
+            SSL_set_session(tls_stream_->native_handle(), tls_session_);
+        }
+
+        tls_stream_->async_handshake(boost::asio::ssl::stream_base::client,
+            boost::bind(&SocketManager::handleTlsHandshake, shared_from_this(),
+                boost::asio::placeholders::error));
     }
     else {
 
-        std::cerr << " : " << error.message() << std::endl;
+        Profiler::endAsync("connect_failed", connect_started_);
+        std::cerr << "연결 실패: " << error.message() << std::endl;
+        handleReconnect();
+    }
+}
+
+// TLS 핸드셰이크 처리
+void SocketManager::handleTlsHandshake(const boost::system::error_code& error) {
+    if (!error) {
+
+        bool resumed = SSL_session_reused(tls_stream_->native_handle()) != 0;
+        std::cout << "TLS 핸드셰이크 완료 (" << SSL_get_version(tls_stream_->native_handle()) << ", "
+            << (resumed ? "세션 재사용" : "전체 핸드셰이크") << ")" << std::endl;
+
+        saveTlsSession();
+        handleTransportReady();
+    }
+    else {
+
+        std::cerr << "TLS 핸드셰이크 실패: " << error.message() << std::endl;
+
+        // 재사용한 세션 때문에 실패했을 수 있으므로 다음에는 전체 핸드셰이크
+        if (tls_session_) {
+            SSL_SESSION_free(tls_session_);
+            tls_session_ = nullptr;
+        }
+
+        boost::system::error_code ec;
+        socket_.close(ec);
         handleReconnect();
     }
 }
 
-// 翬 ó
+// 재연결 시 재사용할 TLS 세션 저장
+void SocketManager::saveTlsSession() {
+
+    if (!tls_stream_) {
+        return;
+    }
+
+    // TLS 1.3 세션 티켓은 핸드셰이크 이후에 도착하므로 연결이 끊길 때도 다시 저장
+    // close_notify 없이 SSL 객체를 해제하면 OpenSSL 이 그 세션을 재사용 불가로 표시하므로 복사본을 보관
+    SSL_SESSION* session = SSL_get_session(tls_stream_->native_handle());
+    if (session && SSL_SESSION_is_resumable(session)) {
+        SSL_SESSION* copy = SSL_SESSION_dup(session);
+        if (copy) {
+            if (tls_session_) {
+                SSL_SESSION_free(tls_session_);
+            }
+            tls_session_ = copy;
+        }
+    }
+}
+
+// 전송 계층 준비 완료
+void SocketManager::handleTransportReady() {
+
+    Profiler::endAsync("connect", connect_started_);
+
+    connected_ = true;
+    reconnect_attempts_ = 0;
+    compression_enabled_ = false;
+    uploads_supported_ = false;
+    binary_control_enabled_ = false;
+    sendHello();
+    if (on_connect_) on_connect_();
+    
+    // 연결 시도부터 (TLS 면 핸드셰이크까지) 걸린 시간
+    double connect_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - connect_time_).count();
+    std::cout << "서버에 연결되었습니다. (" << connect_ms << " ms)" << std::endl;
+
+    doRead();
+    startHeartbeat();
+
+    // 연결이 끊기기 전에 보내지 못한 메시지 전송
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!write_in_progress_ && !write_queue_.empty()) {
+        doWrite();
+    }
+}
+
+// 재연결 처리
 void SocketManager::handleReconnect() {
     if (reconnect_attempts_ < MAX_RECONNECT_ATTEMPTS) {
         reconnect_attempts_++;
-        std::cout << "翬 õ " << reconnect_attempts_ << "/" << MAX_RECONNECT_ATTEMPTS << std::endl;
-        reconnect_timer_.expires_after(boost::asio::chrono::milliseconds(RECONNECT_DELAY_MS));
-        reconnect_timer_.async_wait([this](const boost::system::error_code& ec) {
 
-            if (!ec) {
+        // 응답하는 다른 서버가 있으면 기다리지 않고 바로 옮김
+        int next = endpoint_monitor_ ? endpoint_monitor_->selectBest(static_cast<int>(active_endpoint_)) : -1;
+        if (next >= 0) {
+            std::cout << "다른 서버로 재연결 시도 " << reconnect_attempts_ << "/" << MAX_RECONNECT_ATTEMPTS << std::endl;
+            scheduleConnect(static_cast<size_t>(next), FAILOVER_DELAY_MS);
+            return;
+        }
 
-                connect(current_host_, current_port_);
-            }
-            else {
+        // 그동안 살아난 서버가 있으면 그 서버로, 상태를 모르면 다음 서버로
+        size_t index = active_endpoint_;
+        if (endpoint_monitor_) {
+            int best = endpoint_monitor_->selectBest();
+            index = best >= 0 ? static_cast<size_t>(best) : (active_endpoint_ + 1) % endpoints_.size();
+        }
 
-                std::cerr << "翬 Ÿ̸ : " << ec.message() << std::endl;
-            }
-            });
+        std::cout << "재연결 시도 " << reconnect_attempts_ << "/" << MAX_RECONNECT_ATTEMPTS << std::endl;
+        scheduleConnect(index, RECONNECT_DELAY_MS);
     }
     else {
 
-        std::cout << "ִ 翬 õ Ƚ ʰ.  մϴ." << std::endl;
+        std::cout << "최대 재연결 시도 횟수 초과. 연결을 종료합니다." << std::endl;
+
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            uploads_.clear();
+        }
 
         if (on_disconnect_) 
             on_disconnect_();
     }
 }
 
-//   
+// 잠시 후 목록의 서버에 연결
+void SocketManager::scheduleConnect(size_t index, int delay_ms) {
+
+    reconnect_timer_.expires_after(boost::asio::chrono::milliseconds(delay_ms));
+    reconnect_timer_.async_wait([this, index](const boost::system::error_code& ec) {
+
+        if (!ec) {
+
+            connectEndpoint(index);
+        }
+        else if (ec != boost::asio::error::operation_aborted) {
+
+            std::cerr << "재연결 타이머 오류: " << ec.message() << std::endl;
+        }
+        });
+}
+
+// 프로브 라운드 결과 처리
+void SocketManager::handleProbeRound() {
+
+    // 첫 라운드: 가장 빠른 서버에 연결
+    if (!endpoint_selected_) {
+
+        endpoint_selected_ = true;
+        int best = endpoint_monitor_->selectBest();
+        if (best < 0) {
+            std::cerr << "응답하는 서버가 없습니다. 첫 번째 서버에 연결을 시도합니다." << std::endl;
+            best = 0;
+        }
+        connectEndpoint(static_cast<size_t>(best));
+        return;
+    }
+
+    // 연결이 끊긴 동안은 handleReconnect 가 서버를 고름
+    if (!connected_) {
+        degraded_rounds_ = 0;
+        return;
+    }
+
+    int best = endpoint_monitor_->selectBest(static_cast<int>(active_endpoint_));
+    if (best < 0) {
+        degraded_rounds_ = 0;
+        return;
+    }
+
+    std::vector<EndpointHealth> health = endpoint_monitor_->getHealth();
+    const EndpointHealth& active = health[active_endpoint_];
+    const EndpointHealth& candidate = health[best];
+
+    // 연결은 살아 있어도 서버가 heartbeat 에 응답하지 않음
+    if (active.failures >= FAILED_PROBES) {
+        std::cerr << "연결한 서버가 응답하지 않습니다: " << active.endpoint.host << ":" << active.endpoint.port << std::endl;
+        switchEndpoint(static_cast<size_t>(best));
+        return;
+    }
+
+    // 프로브는 받는 중인 데이터와 같은 경로를 지나므로 한 번 느린 것은 무시하고 연속으로 느릴 때만 옮김
+    bool degraded = active.rttMs > candidate.rttMs * DEGRADED_RTT_RATIO + DEGRADED_RTT_MARGIN_MS;
+    degraded_rounds_ = degraded ? degraded_rounds_ + 1 : 0;
+    if (degraded_rounds_ >= DEGRADED_ROUNDS) {
+        std::cerr << "연결한 서버가 느립니다: " << active.endpoint.host << ":" << active.endpoint.port << " " << active.rttMs << " ms, "
+            << candidate.endpoint.host << ":" << candidate.endpoint.port << " " << candidate.rttMs << " ms" << std::endl;
+        switchEndpoint(static_cast<size_t>(best));
+    }
+}
+
+// 다른 서버로 옮김
+void SocketManager::switchEndpoint(size_t index) {
+
+    if (!connected_) {
+        return;
+    }
+
+    std::cout << "서버 전환: " << current_host_ << ":" << current_port_ << " -> " << endpoints_[index].host << ":" << endpoints_[index].port << std::endl;
+
+    closeConnection();
+    degraded_rounds_ = 0;
+
+    if (on_disconnect_)
+        on_disconnect_();
+
+    reconnect_attempts_ = 0;
+    scheduleConnect(index, FAILOVER_DELAY_MS);
+}
+
+// 연결 끊김 처리
+void SocketManager::handleConnectionLost() {
+
+    if (!connected_) {
+        return;
+    }
+
+    closeConnection();
+
+    std::cout << "서버와의 연결이 끊어졌습니다. 재연결을 시도합니다." << std::endl;
+
+    if (on_disconnect_)
+        on_disconnect_();
+
+    reconnect_attempts_ = 0;
+    handleReconnect();
+}
+
+// 소켓을 닫고 연결 상태 초기화
+void SocketManager::closeConnection() {
+
+    saveTlsSession();
+
+    boost::system::error_code ec;
+    socket_.close(ec);
+    if (shm_channel_) {
+        shm_channel_->close();
+        shm_channel_.reset();
+    }
+    heartbeat_timer_.cancel();
+    pipeline_timer_.cancel();
+    connected_ = false;
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    write_in_progress_ = false;
+
+    // 서버는 연결이 끊기면 받던 업로드를 버리므로 다음 연결에서 처음부터 다시 보냄
+    if (!uploads_.empty()) {
+        std::cerr << "연결이 끊어져 업로드 " << uploads_.size() << "개를 다시 연결한 뒤 처음부터 보냅니다." << std::endl;
+        for (Upload& upload : uploads_) {
+            upload.offset = 0;
+            upload.crc = 0;
+            upload.announced = false;
+        }
+    }
+}
+
+// 서버와 연결 종료
 void SocketManager::disconnect() {
 
+    reconnect_timer_.cancel();
+    pipeline_timer_.cancel();
+
+    if (endpoint_monitor_) {
+        endpoint_monitor_->stop();
+        endpoint_monitor_.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        uploads_.clear();
+    }
+
+    if (shm_channel_) {
+        shm_channel_->close();
+        shm_channel_.reset();
+    }
+
     if (connected_) {
+        saveTlsSession();
+
         boost::system::error_code ec;
         socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
         socket_.close(ec);
         connected_ = false;
 
-        std::cout << "  Ǿϴ." << std::endl;
+        std::cout << "서버와의 연결이 종료되었습니다." << std::endl;
 
         if (on_disconnect_) 
             on_disconnect_();
     }
 }
 
-// ޽ 
+// 메시지 전송
 void SocketManager::send(const Json::Value& message) {
 
     if (!connected_) {
-        std::cerr << "Ǿ  ʾ ޽   ϴ." << std::endl;
+        std::cerr << "연결되어 있지 않아 메시지를 전송할 수 없습니다." << std::endl;
         return;
     }
 
-    Json::FastWriter writer;
-    std::string json_str = writer.write(message);
+    OutgoingFrame frame;
+    makeFrame(message, frame);
 
     std::lock_guard<std::mutex> lock(write_mutex_);
-    bool write_in_progress = !write_queue_.empty();
-    write_queue_.push(json_str);
+    write_queue_.push(std::move(frame));
+    scheduleWrite();
+}
 
-    if (!write_in_progress) {
-        doWrite();
+// io 스레드에서 전송 시작
+void SocketManager::scheduleWrite() {
+
+    // UI 스레드나 파이프라인 스레드에서 호출되어도 io 스레드의 읽기와 같은 TLS 스트림을 동시에 건드리지 않도록 넘김
+    if (write_in_progress_ || write_scheduled_) {
+        return;
+    }
+
+    write_scheduled_ = true;
+    auto self(shared_from_this());
+    boost::asio::post(io_context_, [this, self]() {
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        write_scheduled_ = false;
+        if (connected_ && !write_in_progress_ && (!write_queue_.empty() || !uploads_.empty())) {
+            doWrite();
+        }
+        });
+}
+
+// 전송할 프레임 준비
+void SocketManager::makeFrame(const Json::Value& message, OutgoingFrame& frame) {
+
+    Json::FastWriter writer;
+    frame.payload = writer.write(message);
+    frame.header = 0;
+
+    // 바이너리 형식이 있는 제어 메시지는 미리 인코딩 (협상 결과에 따라 보낼 때 선택)
+    if (!ControlMessage::fromJson(message, frame.control)) {
+        frame.control.clear();
     }
 }
 
-//    Ȯ
+// 파일 업로드
+uint32_t SocketManager::uploadFile(std::shared_ptr<const UploadFile> file) {
+
+    if (!connected_ || !uploads_supported_) {
+        std::cerr << "서버가 업로드를 지원하지 않거나 연결되어 있지 않습니다." << std::endl;
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    Upload upload;
+    upload.transfer_id = ++last_upload_id_;
+    upload.file = file;
+    upload.offset = 0;
+    upload.crc = 0;
+    upload.announced = false;
+    uploads_.push_back(upload);
+    scheduleWrite();
+
+    return upload.transfer_id;
+}
+
+// 현재 연결 상태 확인
 bool SocketManager::isConnected() const {
     return connected_;
 }
 
-//  ̺Ʈ  
+// 수신 이벤트 리스너 설정
 void SocketManager::setOnReceiveListener(std::function<void(const Json::Value&)> listener) {
     on_receive_ = listener;
 }
 
-//   ̺Ʈ  
+// 연결 성공 이벤트 리스너 설정
 void SocketManager::setOnConnectListener(std::function<void()> listener) {
     on_connect_ = listener;
 }
 
-//   ̺Ʈ  
+// 연결 종료 이벤트 리스너 설정
 void SocketManager::setOnDisconnectListener(std::function<void()> listener) {
     on_disconnect_ = listener;
 }
 
-//  Ϸ ̺Ʈ  
+// 전송 완료 이벤트 리스너 설정
 void SocketManager::setOnSendCompleteListener(std::function<void(size_t)> listener) {
     on_send_complete_ = listener;
 }
 
-// 񵿱 ޽  ó
+// 바이너리 파일 청크 수신 리스너 설정
+void SocketManager::setOnBinaryChunkListener(std::function<void(const BinaryChunkHeader&, const char*, size_t)> listener) {
+    on_binary_chunk_ = listener;
+}
+
+// 받은 프레임을 io 스레드 밖에서 처리할 리스너 설정
+void SocketManager::setOnFrameListener(std::function<bool(uint32_t, std::vector<char>&)> listener) {
+    on_frame_ = listener;
+}
+
+// 큰 프레임을 조각으로 받을 리스너 설정
+void SocketManager::setOnFrameSliceListener(std::function<bool(uint32_t, size_t)> accept, std::function<bool(const FrameSlice&, std::vector<char>&)> listener) {
+    on_frame_slice_accept_ = accept;
+    on_frame_slice_ = listener;
+}
+
+// 수신 프레임 처리에 io 스레드가 쓴 시간
+uint64_t SocketManager::getReceiveBusyMicroseconds() const {
+    return receive_busy_us_;
+}
+
+// 서버가 구간 요청을 지원하는지
+bool SocketManager::supportsStripes() const {
+    return stripes_supported_;
+}
+
+// 프레임 압축 통계
+CompressionStats SocketManager::getCompressionStats() const {
+
+    CompressionStats stats;
+    stats.raw_bytes_sent = raw_bytes_sent_;
+    stats.wire_bytes_sent = wire_bytes_sent_;
+    stats.raw_bytes_received = raw_bytes_received_;
+    stats.wire_bytes_received = wire_bytes_received_;
+    stats.compress_time_us = compress_time_us_;
+    stats.decompress_time_us = decompress_time_us_;
+    return stats;
+}
+
+// 송수신 프레임 녹화 시작
+bool SocketManager::startRecording(const std::string& path) {
+
+    recording_ = false;
+    if (!recorder_.open(path)) {
+        return false;
+    }
+
+    recording_ = true;
+    std::cout << "프레임 녹화 시작: " << path << std::endl;
+    return true;
+}
+
+// 송수신 프레임 녹화 중지
+void SocketManager::stopRecording() {
+
+    recording_ = false;
+    recorder_.close();
+}
+
+// 캡처 파일의 수신 프레임 재생
+bool SocketManager::replayCapture(const std::string& path, bool realtime, ReplayStats& stats) {
+
+    // 재생 프레임이 실제 수신 프레임과 같은 버퍼와 파이프라인을 쓰므로 연결 중에는 재생하지 않음
+    if (connected_) {
+        std::cerr << "연결 중에는 캡처를 재생할 수 없습니다." << std::endl;
+        return false;
+    }
+
+    return FrameReplayer::replay(path, realtime, [this](const CapturedFrame& frame) {
+
+        if (frame.direction != FrameDirection::Inbound) {
+            return;
+        }
+
+        message_buffer_.assign(frame.data, frame.data + frame.size);
+        message_flags_ = frame.flags;
+
+        // 재생은 속도를 맞출 필요가 없으므로 파이프라인이 빌 때까지 기다림
+        while (!dispatchFrame()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(PIPELINE_RETRY_MS));
+        }
+
+        }, stats);
+}
+
+// TLS, 공유 메모리 여부에 따라 읽기
+template <typename MutableBuffers, typename Handler>
+void SocketManager::asyncRead(const MutableBuffers& buffers, Handler&& handler) {
+
+    if (shm_channel_) {
+        std::vector<boost::asio::mutable_buffer> sequence(boost::asio::buffer_sequence_begin(buffers), boost::asio::buffer_sequence_end(buffers));
+        shm_channel_->asyncRead(sequence, ShmChannel::Handler(std::forward<Handler>(handler)));
+    }
+    else if (tls_stream_) {
+        boost::asio::async_read(*tls_stream_, buffers, std::forward<Handler>(handler));
+    }
+    else {
+        boost::asio::async_read(socket_, buffers, std::forward<Handler>(handler));
+    }
+}
+
+// TLS, 공유 메모리 여부에 따라 쓰기
+template <typename ConstBuffers, typename Handler>
+void SocketManager::asyncWrite(const ConstBuffers& buffers, Handler&& handler) {
+
+    if (shm_channel_) {
+        std::vector<boost::asio::const_buffer> sequence(boost::asio::buffer_sequence_begin(buffers), boost::asio::buffer_sequence_end(buffers));
+        shm_channel_->asyncWrite(sequence, ShmChannel::Handler(std::forward<Handler>(handler)));
+    }
+    else if (tls_stream_) {
+        boost::asio::async_write(*tls_stream_, buffers, std::forward<Handler>(handler));
+    }
+    else {
+        boost::asio::async_write(socket_, buffers, std::forward<Handler>(handler));
+    }
+}
+
+// 비동기 메시지 수신 처리
 void SocketManager::doRead() {
 
     auto self(shared_from_this());
-    boost::asio::async_read(socket_,
-        boost::asio::buffer(&message_length_, sizeof(uint32_t)),
-        [this, self](boost::system::error_code ec, std::size_t) {
+    int64_t started = Profiler::begin();
+    asyncRead(boost::asio::buffer(&message_length_, sizeof(uint32_t)),
+        [this, self, started](boost::system::error_code ec, std::size_t) {
+
+            Profiler::endAsync("read_header", started);
 
             if (!ec) {
 
-                message_length_ = boost::endian::big_to_native(message_length_);
-                if (message_length_ > MAX_MESSAGE_SIZE) {
-                    std::cerr << "޽ ũⰡ ʹ Ůϴ.  մϴ." << std::endl;
+                size_t length;
+                FrameCodec::decodeHeader(message_length_, length, message_flags_);
+                if (length > FrameCodec::MAX_MESSAGE_SIZE) {
+                    std::cerr << "메시지 크기가 너무 큽니다. 연결을 종료합니다." << std::endl;
                     disconnect();
                     return;
                 }
 
-                message_buffer_.resize(message_length_);
-                boost::asio::async_read(socket_,
-                    boost::asio::buffer(message_buffer_),
-                    [this, self](boost::system::error_code ec, std::size_t) {
-
-                        if (!ec) {
-                            handleMessage();
-                            doRead();
-                        }
-                        else {
-                            std::cerr << " : " << ec.message() << std::endl;
-                            disconnect();
-                        }
-                    });
+                wire_bytes_received_ += sizeof(uint32_t);
+
+                // 큰 프레임은 원하는 리스너에게 도착하는 대로 조각으로 넘김
+                if (length > STREAM_SLICE_SIZE && on_frame_slice_accept_ && on_frame_slice_accept_(message_flags_, length)) {
+                    slice_frame_size_ = length;
+                    slice_offset_ = 0;
+                    readFrameSlice();
+                    return;
+                }
+
+                message_buffer_.clear();
+                readFrameBody(length);
             }
             else {
 
-                std::cerr << " : " << ec.message() << std::endl;
-                disconnect();
+                std::cerr << "수신 오류: " << ec.message() << std::endl;
+                handleConnectionLost();
+            }
+        });
+}
+
+// 프레임 본문 수신
+void SocketManager::readFrameBody(size_t length) {
+
+    // 길이 필드만 믿고 한 번에 할당하지 않고 STREAM_SLICE_SIZE 씩 받은 만큼 늘림 (작은 프레임은 한 번에 읽음)
+    size_t received = message_buffer_.size();
+    size_t slice = (std::min)(length - received, STREAM_SLICE_SIZE);
+    message_buffer_.resize(received + slice);
+
+    auto self(shared_from_this());
+    int64_t started = Profiler::begin();
+    asyncRead(boost::asio::buffer(message_buffer_.data() + received, slice),
+        [this, self, length, started](boost::system::error_code ec, std::size_t bytes_transferred) {
+
+            Profiler::endAsync("read_body", started);
+
+            if (ec) {
+                std::cerr << "수신 오류: " << ec.message() << std::endl;
+                handleConnectionLost();
+                return;
+            }
+
+            wire_bytes_received_ += bytes_transferred;
+
+            if (message_buffer_.size() < length) {
+                readFrameBody(length);
+                return;
+            }
+
+            if (recording_) {
+                recorder_.record(FrameDirection::Inbound, message_flags_, message_buffer_.data(), message_buffer_.size());
             }
+
+            deliverFrame();
+        });
+}
+
+// 큰 프레임의 다음 조각 수신
+void SocketManager::readFrameSlice() {
+
+    slice_buffer_.resize((std::min)(slice_frame_size_ - slice_offset_, STREAM_SLICE_SIZE));
+
+    auto self(shared_from_this());
+    int64_t started = Profiler::begin();
+    asyncRead(boost::asio::buffer(slice_buffer_),
+        [this, self, started](boost::system::error_code ec, std::size_t bytes_transferred) {
+
+            Profiler::endAsync("read_slice", started);
+
+            if (ec) {
+                std::cerr << "수신 오류: " << ec.message() << std::endl;
+                handleConnectionLost();
+                return;
+            }
+
+            wire_bytes_received_ += bytes_transferred;
+            deliverFrameSlice();
         });
 }
 
-// 񵿱 ޽  ó
+// 받은 조각 넘기기
+void SocketManager::deliverFrameSlice() {
+
+    auto start = std::chrono::steady_clock::now();
+
+    FrameSlice slice;
+    slice.flags = message_flags_;
+    slice.frame_size = slice_frame_size_;
+    slice.offset = slice_offset_;
+
+    size_t size = slice_buffer_.size();
+    bool delivered;
+    {
+        ProfileScope scope("dispatch_slice");
+        delivered = on_frame_slice_(slice, slice_buffer_);
+    }
+
+    receive_busy_us_ += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    auto self(shared_from_this());
+    if (!delivered) {
+
+        pipeline_timer_.expires_after(boost::asio::chrono::milliseconds(PIPELINE_RETRY_MS));
+        pipeline_timer_.async_wait([this, self](const boost::system::error_code& error) {
+
+            if (!error && connected_) {
+                deliverFrameSlice();
+            }
+            });
+        return;
+    }
+
+    raw_bytes_received_ += size;
+    slice_offset_ += size;
+
+    if (slice_offset_ < slice_frame_size_) {
+        readFrameSlice();
+    }
+    else {
+        doRead();
+    }
+}
+
+// 비동기 메시지 전송 처리
 void SocketManager::doWrite() {
 
-    auto& message = write_queue_.front();
-    uint32_t length = boost::endian::native_to_big(static_cast<uint32_t>(message.size()));
+    ProfileScope scope("doWrite");
+    write_in_progress_ = true;
+
+    // 제어 메시지를 먼저 보내고, 대기열이 비었을 때만 업로드 청크 전송
+    if (write_queue_.empty()) {
+
+        // 재연결 후 hello_ack 로 업로드 지원이 확인될 때까지 업로드는 보류 (hello_ack 처리에서 다시 시작)
+        if (!uploads_supported_ || uploads_.empty()) {
+            write_in_progress_ = false;
+            return;
+        }
+
+        writeUploadChunks();
+        return;
+    }
+
+    // 압축과 바이너리 제어 메시지는 실제로 보낼 때 결정 (재연결 후 협상 전이면 원본 JSON 전송)
+    auto& frame = write_queue_.front();
+    bool control = binary_control_enabled_ && !frame.control.empty();
+    if (!control && compression_enabled_ && frame.compressed.empty() && frame.payload.size() >= FrameCodec::MIN_COMPRESS_SIZE) {
+        compressFrame(frame.payload, frame.compressed);
+    }
+
+    const std::string& message = control ? frame.control : (compression_enabled_ && !frame.compressed.empty()) ? frame.compressed : frame.payload;
+    uint32_t flags = control ? FrameCodec::CONTROL_FLAG : (&message == &frame.compressed) ? FrameCodec::COMPRESSED_FLAG : 0;
+    frame.header = FrameCodec::encodeHeader(message.size(), flags);
+
+    raw_bytes_sent_ += control ? message.size() : frame.payload.size();
+    wire_bytes_sent_ += message.size() + sizeof(uint32_t);
+
+    if (recording_) {
+        recorder_.record(FrameDirection::Outbound, flags, message.data(), message.size());
+    }
 
     std::vector<boost::asio::const_buffer> buffers;
-    buffers.push_back(boost::asio::buffer(&length, sizeof(uint32_t)));
+    buffers.push_back(boost::asio::buffer(&frame.header, sizeof(uint32_t)));
     buffers.push_back(boost::asio::buffer(message));
 
-    boost::asio::async_write(socket_, buffers,
-        [this](boost::system::error_code ec, std::size_t bytes_transferred) {
+    int64_t started = Profiler::begin();
+    asyncWrite(buffers,
+        [this, started](boost::system::error_code ec, std::size_t bytes_transferred) {
+
+            Profiler::endAsync("write", started);
 
             if (!ec) {
 
                 std::lock_guard<std::mutex> lock(write_mutex_);
                 write_queue_.pop();
-                if (!write_queue_.empty()) {
+                write_in_progress_ = false;
+                if (!write_queue_.empty() || !uploads_.empty()) {
                     doWrite();
                 }
                 if (on_send_complete_) on_send_complete_(bytes_transferred - sizeof(uint32_t));
             }
             else {
 
-                std::cerr << " : " << ec.message() << std::endl;
-                disconnect();
+                std::cerr << "전송 오류: " << ec.message() << std::endl;
+                handleConnectionLost();
             }
         });
 }
 
-// ŵ ޽ ó
+// 업로드 청크 전송
+void SocketManager::writeUploadChunks() {
+
+    Upload& upload = uploads_.front();
+
+    // upload_start 는 앞선 제어 메시지와 같은 대기열로 보내서 청크보다 먼저 도착하게 함 (다시 연결하면 다시 보냄)
+    if (!upload.announced) {
+
+        Json::Value start;
+        start["type"] = "upload_start";
+        start["content"]["transfer_id"] = upload.transfer_id;
+        start["content"]["filename"] = upload.file->getFileName();
+        start["content"]["filesize"] = static_cast<Json::UInt64>(upload.file->getFileSize());
+
+        OutgoingFrame frame;
+        makeFrame(start, frame);
+        write_queue_.push(std::move(frame));
+        upload.announced = true;
+        doWrite();
+        return;
+    }
+
+    uint64_t file_size = upload.file->getFileSize();
+    if (upload.offset >= file_size) {
+        finishUpload();
+        doWrite();
+        return;
+    }
+
+    // 전송이 끝날 때까지 매핑과 프레임 헤더를 유지
+    struct UploadBatch {
+        std::shared_ptr<boost::interprocess::mapped_region> region;
+        std::vector<std::array<char, sizeof(uint32_t) + FrameCodec::BINARY_CHUNK_HEADER_SIZE>> headers;
+    };
+
+    auto batch = std::make_shared<UploadBatch>();
+    size_t length = static_cast<size_t>((std::min)(static_cast<uint64_t>(UPLOAD_SEND_BUDGET), file_size - upload.offset));
+    batch->region = upload.file->map(upload.offset, length);
+    if (!batch->region) {
+
+        std::cerr << "업로드를 취소합니다: " << upload.file->getFileName() << std::endl;
+
+        Json::Value cancel;
+        cancel["type"] = "upload_cancel";
+        cancel["content"]["transfer_id"] = upload.transfer_id;
+
+        OutgoingFrame frame;
+        makeFrame(cancel, frame);
+        write_queue_.push(std::move(frame));
+        uploads_.pop_front();
+        doWrite();
+        return;
+    }
+
+    // 청크 데이터는 매핑한 구간을 그대로 가리킴 (헤더만 따로 만듦)
+    const char* data = static_cast<const char*>(batch->region->get_address());
+    size_t chunk_count = (length + UPLOAD_CHUNK_SIZE - 1) / UPLOAD_CHUNK_SIZE;
+    batch->headers.resize(chunk_count);
+
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(chunk_count * 2);
+    for (size_t i = 0; i < chunk_count; ++i) {
+
+        size_t position = i * UPLOAD_CHUNK_SIZE;
+        size_t size = (std::min)(UPLOAD_CHUNK_SIZE, length - position);
+
+        BinaryChunkHeader header;
+        header.transfer_id = upload.transfer_id;
+        header.offset = upload.offset + position;
+        header.crc = Crc32c::update(0, data + position, size);
+        upload.crc = Crc32c::combine(upload.crc, header.crc, size);
+
+        char* out = batch->headers[i].data();
+        uint32_t frame_header = FrameCodec::encodeHeader(FrameCodec::BINARY_CHUNK_HEADER_SIZE + size, FrameCodec::BINARY_CHUNK_FLAG);
+        memcpy(out, &frame_header, sizeof(uint32_t));
+        FrameCodec::encodeBinaryChunkHeader(header, out + sizeof(uint32_t));
+
+        buffers.push_back(boost::asio::buffer(batch->headers[i]));
+        buffers.push_back(boost::asio::buffer(data + position, size));
+    }
+
+    upload.offset += length;
+    raw_bytes_sent_ += length;
+    wire_bytes_sent_ += length + chunk_count * batch->headers[0].size();
+
+    int64_t started = Profiler::begin();
+    asyncWrite(buffers,
+        [this, batch, started](boost::system::error_code ec, std::size_t) {
+
+            Profiler::endAsync("write_upload", started);
+
+            if (!ec) {
+
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                write_in_progress_ = false;
+                if (!write_queue_.empty() || !uploads_.empty()) {
+                    doWrite();
+                }
+            }
+            else {
+
+                std::cerr << "업로드 전송 오류: " << ec.message() << std::endl;
+                handleConnectionLost();
+            }
+        });
+}
+
+// 다 보낸 업로드 마무리
+void SocketManager::finishUpload() {
+
+    const Upload& upload = uploads_.front();
+
+    Json::Value end;
+    end["type"] = "upload_end";
+    end["content"]["transfer_id"] = upload.transfer_id;
+    end["content"]["filename"] = upload.file->getFileName();
+    end["content"]["crc"] = upload.crc;
+
+    OutgoingFrame frame;
+    makeFrame(end, frame);
+    write_queue_.push(std::move(frame));
+    uploads_.pop_front();
+}
+
+// 수신된 프레임 넘기기
+bool SocketManager::dispatchFrame() {
+
+    auto start = std::chrono::steady_clock::now();
+    bool delivered = true;
+
+    if (on_frame_) {
+
+        // 압축 해제는 리스너 쪽 스레드에서 하므로 원본 크기는 압축 프레임 앞의 원본 길이로 셈
+        size_t raw_size = message_buffer_.size();
+        if ((message_flags_ & FrameCodec::COMPRESSED_FLAG) && raw_size >= sizeof(uint32_t)) {
+            uint32_t original_size;
+            memcpy(&original_size, message_buffer_.data(), sizeof(uint32_t));
+            raw_size = boost::endian::big_to_native(original_size);
+        }
+
+        ProfileScope scope("dispatch_frame");
+        delivered = on_frame_(message_flags_, message_buffer_);
+        if (delivered) {
+            raw_bytes_received_ += raw_size;
+        }
+    }
+    else {
+
+        handleMessage();
+    }
+
+    receive_busy_us_ += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return delivered;
+}
+
+// 넘기지 못한 프레임을 잠시 후 다시 넘기고 다음 프레임 수신
+void SocketManager::deliverFrame() {
+
+    if (dispatchFrame()) {
+        doRead();
+        return;
+    }
+
+    // 처리 스레드가 밀려 있으면 소켓을 읽지 않고 기다림 (TCP 흐름 제어로 서버 전송도 느려짐)
+    auto self(shared_from_this());
+    pipeline_timer_.expires_after(boost::asio::chrono::milliseconds(PIPELINE_RETRY_MS));
+    pipeline_timer_.async_wait([this, self](const boost::system::error_code& error) {
+
+        if (!error && connected_) {
+            deliverFrame();
+        }
+        });
+}
+
+// 수신된 메시지 처리
 void SocketManager::handleMessage() {
 
+    ProfileScope scope("handleMessage");
+
+    // 바이너리 제어 메시지는 JSON 으로 바꿔서 같은 경로로 처리 (하트비트처럼 드문 메시지만 이 경로로 옴)
+    if (message_flags_ & FrameCodec::CONTROL_FLAG) {
+
+        ControlView view;
+        if (!view.parse(message_buffer_.data(), message_buffer_.size())) {
+            std::cerr << "잘못된 제어 메시지." << std::endl;
+            return;
+        }
+
+        raw_bytes_received_ += message_buffer_.size();
+        dispatchMessage(ControlMessage::toJson(view));
+        return;
+    }
+
+    // 바이너리 파일 청크는 JSON 파싱 없이 바로 전달
+    if (message_flags_ & FrameCodec::BINARY_CHUNK_FLAG) {
+
+        BinaryChunkHeader header;
+        if (!FrameCodec::decodeBinaryChunkHeader(message_buffer_.data(), message_buffer_.size(), header)) {
+            std::cerr << "잘못된 바이너리 청크." << std::endl;
+            return;
+        }
+
+        raw_bytes_received_ += message_buffer_.size();
+        if (on_binary_chunk_) {
+            ProfileScope listener_scope("on_binary_chunk");
+            on_binary_chunk_(header, message_buffer_.data() + FrameCodec::BINARY_CHUNK_HEADER_SIZE, message_buffer_.size() - FrameCodec::BINARY_CHUNK_HEADER_SIZE);
+        }
+        return;
+    }
+
+    const std::vector<char>* payload = &message_buffer_;
+    if (message_flags_ & FrameCodec::COMPRESSED_FLAG) {
+        if (!decompressFrame()) {
+            std::cerr << "압축 해제 실패." << std::endl;
+            return;
+        }
+        payload = &decompress_buffer_;
+    }
+
+    raw_bytes_received_ += payload->size();
+
     Json::Value json_message;
     Json::Reader reader;
-    if (reader.parse(message_buffer_.data(), message_buffer_.data() + message_buffer_.size(), json_message)) {
+    bool parsed;
+    {
+        ProfileScope parse_scope("parseJson");
+        parsed = reader.parse(payload->data(), payload->data() + payload->size(), json_message);
+    }
 
-        if (on_receive_)
-            on_receive_(json_message);
+    if (parsed) {
+        dispatchMessage(json_message);
     }
     else {
-        std::cerr << "޽ Ľ ." << std::endl;
+        std::cerr << "메시지 파싱 실패." << std::endl;
+    }
+}
+
+// 디코딩된 메시지 처리
+void SocketManager::dispatchMessage(const Json::Value& message) {
+
+    // 기능 협상 응답은 내부에서 처리
+    if (message["type"].asString() == "hello_ack") {
+        compression_enabled_ = message["content"]["compression"].asString() == "lz4";
+        stripes_supported_ = message["content"]["stripes"].asBool();
+        uploads_supported_ = message["content"]["uploads"].asBool();
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (!uploads_supported_ && !uploads_.empty()) {
+                std::cerr << "서버가 업로드를 지원하지 않아 업로드 " << uploads_.size() << "개를 취소합니다." << std::endl;
+                uploads_.clear();
+            }
+
+            // 협상 전까지 보류했던 업로드 재개
+            if (uploads_supported_ && !uploads_.empty() && !write_in_progress_) {
+                doWrite();
+            }
+        }
+        binary_control_enabled_ = message["content"]["binary_control"].asBool();
+        std::cout << "프레임 압축: " << (compression_enabled_ ? "lz4" : "사용 안 함")
+            << ", 바이너리 청크: " << (message["content"]["binary_chunks"].asBool() ? "사용" : "사용 안 함")
+            << ", 바이너리 제어 메시지: " << (binary_control_enabled_ ? "사용" : "사용 안 함")
+            << ", 업로드: " << (uploads_supported_ ? "사용" : "사용 안 함")
+            << ", 동시 전송: " << message["content"].get("max_transfers", 1).asUInt() << std::endl;
+        return;
+    }
+
+    if (on_receive_) {
+        ProfileScope scope("on_receive");
+        on_receive_(message);
     }
 }
 
-// ƮƮ 
+// 하트비트 시작
 void SocketManager::startHeartbeat() {
 
     heartbeat_timer_.expires_after(boost::asio::chrono::milliseconds(HEARTBEAT_INTERVAL_MS));
@@ -251,10 +1245,43 @@ void SocketManager::startHeartbeat() {
             Json::Value heartbeat;
             heartbeat["type"] = "heartbeat";
             send(heartbeat);
-            startHeartbeat(); //  ƮƮ 
+            startHeartbeat(); // 다음 하트비트를 예약
         }
         else if (error) {
-            std::cerr << "ƮƮ Ÿ̸ : " << error.message() << std::endl;
+            std::cerr << "하트비트 타이머 오류: " << error.message() << std::endl;
         }
         });
 }
+
+// 기능 협상 요청 (압축, 바이너리 청크, 바이너리 제어 메시지)
+void SocketManager::sendHello() {
+
+    Json::Value compression(Json::arrayValue);
+    compression.append("lz4");
+
+    Json::Value hello;
+    hello["type"] = "hello";
+    hello["content"]["compression"] = compression;
+    hello["content"]["binary_chunks"] = static_cast<bool>(on_binary_chunk_) || static_cast<bool>(on_frame_);
+    hello["content"]["max_transfers"] = static_cast<Json::UInt>(max_transfers_);
+    hello["content"]["binary_control"] = true;
+    send(hello);
+}
+
+// 전송할 프레임 압축
+bool SocketManager::compressFrame(const std::string& payload, std::string& compressed) {
+
+    auto start = std::chrono::steady_clock::now();
+    bool result = FrameCodec::compress(payload.data(), payload.size(), compressed);
+    compress_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// 수신한 프레임 압축 해제
+bool SocketManager::decompressFrame() {
+
+    auto start = std::chrono::steady_clock::now();
+    bool result = FrameCodec::decompress(message_buffer_.data(), message_buffer_.size(), decompress_buffer_);
+    decompress_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -1,88 +1,310 @@
 #pragma once
 #include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
 #include <json/json.h>
+#include "FrameCapture.h"
+#include "FrameCodec.h"
+#include "ControlMessage.h"
+#include "EndpointMonitor.h"
+#include "FileManager.h"
+#include "ShmChannel.h"
+#include "Profiler.h"
 #include <functional>
 #include <string>
+#include <vector>
 #include <queue>
+#include <deque>
 #include <mutex>
 #include <memory>
 #include <atomic>
+#include <chrono>
 #include <iostream>
 
+// 프레임 압축 통계
+struct CompressionStats {
+    uint64_t raw_bytes_sent; // 압축 전 보낸 바이트
+    uint64_t wire_bytes_sent; // 실제로 보낸 바이트
+    uint64_t raw_bytes_received; // 압축 해제 후 받은 바이트
+    uint64_t wire_bytes_received; // 실제로 받은 바이트
+    uint64_t compress_time_us; // 압축에 쓴 시간 (마이크로초)
+    uint64_t decompress_time_us; // 압축 해제에 쓴 시간 (마이크로초)
+};
+
+// 조각으로 받는 큰 프레임의 한 조각
+struct FrameSlice {
+    uint32_t flags; // 프레임 플래그
+    size_t frame_size; // 프레임 본문 전체 크기
+    size_t offset; // 이 조각의 본문 안 위치 (offset + 조각 크기 == frame_size 이면 마지막 조각)
+};
+
 class SocketManager : public std::enable_shared_from_this<SocketManager> {
 public:
-    // 
+    // 생성자
     static std::shared_ptr<SocketManager> create(boost::asio::io_context& io_context);
     ~SocketManager();
 
-    //  
+    // 서버에 연결 (host 가 "tls://" 로 시작하면 TLS 사용)
     void connect(const std::string& host, int port);
 
-    //   
+    // 여러 서버 중 왕복 시간이 가장 짧은 정상 서버에 연결 (서버가 하나면 바로 연결)
+    // 연결한 뒤에도 모든 서버를 계속 측정하다가 연결한 서버가 응답하지 않거나 느려지면, 또는 연결이 끊기면 바로 다른 서버로 옮김
+    // 보내지 못한 메시지와 업로드는 옮긴 서버로 이어서 보냄 (다운로드 이어받기는 연결 이벤트 리스너에서)
+    // 어느 스레드에서 호출해도 연결 종료, 서버 목록 교체, 연결 시작은 io 스레드에서 실행
+    void connect(const std::vector<ServerEndpoint>& endpoints);
+
+    // 연결 중이거나 마지막으로 연결을 시도한 서버
+    ServerEndpoint getActiveEndpoint() const;
+
+    // 서버별 왕복 시간과 상태 (서버가 하나면 빈 목록)
+    std::vector<EndpointHealth> getEndpointHealth() const;
+
+    // TLS 서버 인증서 검증에 사용할 CA 파일 (자체 서명 인증서 테스트용)
+    void setTlsCaFile(const std::string& ca_file);
+
+    // 동시에 받을 수 있는 파일 수 (hello 로 서버에 알림, 기본 1)
+    void setMaxTransfers(size_t max_transfers);
+
+    // 서버와 연결 종료
     void disconnect();
 
-    // ޽ 
+    // 메시지 전송
     void send(const Json::Value& message);
 
-    //    Ȯ
+    // 현재 연결 상태 확인
     bool isConnected() const;
 
-    //  ̺Ʈ  
+    // 수신 이벤트 리스너 설정
     void setOnReceiveListener(std::function<void(const Json::Value&)> listener);
 
-    //   ̺Ʈ  
+    // 연결 성공 이벤트 리스너 설정
     void setOnConnectListener(std::function<void()> listener);
 
-    //   ̺Ʈ  
+    // 연결 종료 이벤트 리스너 설정
     void setOnDisconnectListener(std::function<void()> listener);
 
-    //  Ϸ ̺Ʈ  
+    // 전송 완료 이벤트 리스너 설정
     void setOnSendCompleteListener(std::function<void(size_t)> listener);
 
+    // 바이너리 파일 청크 수신 리스너 설정 (서버가 binary_chunks 를 수락한 경우)
+    void setOnBinaryChunkListener(std::function<void(const BinaryChunkHeader&, const char*, size_t)> listener);
+
+    // 받은 프레임을 io 스레드 밖에서 처리할 리스너 설정 (payload 는 바꿔 끼워도 됨, 가득 차서 못 받으면 false)
+    // 설정하면 on_receive_, on_binary_chunk_ 대신 호출되고 false 를 받으면 잠시 수신을 멈춤
+    void setOnFrameListener(std::function<bool(uint32_t, std::vector<char>&)> listener);
+
+    // 큰 프레임(STREAM_SLICE_SIZE 초과)을 도착하는 대로 조각으로 받을 리스너 설정
+    // accept 가 true 를 돌려준 프레임만 조각으로 전달 (조각 버퍼는 바꿔 끼워도 됨, 가득 차서 못 받으면 false)
+    // 조각으로 받은 프레임은 녹화하지 않음
+    void setOnFrameSliceListener(std::function<bool(uint32_t, size_t)> accept, std::function<bool(const FrameSlice&, std::vector<char>&)> listener);
+
+    // 다른 스레드에서 디코딩한 메시지 처리 (io 스레드에서 호출)
+    void dispatchMessage(const Json::Value& message);
+
+    // 수신 프레임 처리에 io 스레드가 쓴 시간 (마이크로초)
+    uint64_t getReceiveBusyMicroseconds() const;
+
+    // 서버가 구간 요청(stripe_request)을 지원하는지 (hello_ack 수신 후)
+    bool supportsStripes() const;
+
+    // 파일 업로드 (서버가 uploads 를 수락한 경우, 전송 ID 반환, 실패하면 0)
+    // 청크는 매핑한 파일 구간을 그대로 보내고, 제어 메시지가 밀려 있으면 먼저 보냄
+    // 업로드 청크는 녹화하지 않고, 연결이 끊기면 다시 연결한 서버에 처음부터 다시 보냄
+    uint32_t uploadFile(std::shared_ptr<const UploadFile> file);
+
+    // 프레임 압축 통계
+    CompressionStats getCompressionStats() const;
+
+    // 송수신 프레임 녹화 시작 (io 스레드에서 호출)
+    bool startRecording(const std::string& path);
+
+    // 송수신 프레임 녹화 중지 (io 스레드에서 호출)
+    void stopRecording();
+
+    // 캡처 파일의 수신 프레임을 네트워크 없이 수신 경로로 재생 (io 스레드에서 호출, 연결 중이면 실패)
+    bool replayCapture(const std::string& path, bool realtime, ReplayStats& stats);
+
 private:
-    //  (private)
+    // 생성자 (private)
     SocketManager(boost::asio::io_context& io_context);
 
-    // 񵿱  ó
+    // 서버 목록 교체 후 연결 시작 (connect 가 io 스레드로 넘김)
+    void startConnect(const std::vector<ServerEndpoint>& endpoints);
+
+    // 목록의 서버에 연결
+    void connectEndpoint(size_t index);
+
+    // 잠시 후 목록의 서버에 연결
+    void scheduleConnect(size_t index, int delay_ms);
+
+    // 프로브 라운드 결과로 처음 연결할 서버를 고르고, 연결한 서버가 응답하지 않거나 느려졌으면 옮김
+    void handleProbeRound();
+
+    // 연결을 끊고 다른 서버로 옮김
+    void switchEndpoint(size_t index);
+
+    // 비동기 연결 처리
     void doConnect(const boost::asio::ip::tcp::resolver::results_type& endpoints);
 
-    //  ó
+    // 연결 처리
     void handleConnect(const boost::system::error_code& error, const boost::asio::ip::tcp::endpoint& endpoint);
 
-    // ޽  ó
+    // TLS 핸드셰이크 처리
+    void handleTlsHandshake(const boost::system::error_code& error);
+
+    // 전송 계층 준비 완료 (TCP 연결 또는 TLS 핸드셰이크 이후)
+    void handleTransportReady();
+
+    // 재연결 시 재사용할 TLS 세션 저장
+    void saveTlsSession();
+
+    // TLS, 공유 메모리 여부에 따라 읽기/쓰기
+    template <typename MutableBuffers, typename Handler>
+    void asyncRead(const MutableBuffers& buffers, Handler&& handler);
+
+    template <typename ConstBuffers, typename Handler>
+    void asyncWrite(const ConstBuffers& buffers, Handler&& handler);
+
+    // 메시지 수신 처리
     void doRead();
 
-    // ޽  ó
+    // io 스레드에서 전송 시작 (다른 스레드가 소켓이나 TLS 스트림에 직접 쓰지 않도록, write_mutex_ 를 잡은 상태에서 호출)
+    void scheduleWrite();
+
+    // 메시지 전송 처리 (io 스레드에서만 호출)
     void doWrite();
 
-    // ŵ ޽ ó
+    // 업로드 청크를 UPLOAD_SEND_BUDGET 만큼 모아 전송
+    void writeUploadChunks();
+
+    // 다 보낸 업로드의 upload_end 를 전송 대기열에 넣음 (write_mutex_ 를 잡은 상태에서 호출)
+    void finishUpload();
+
+    // 프레임 본문 수신 (받은 만큼만 버퍼를 늘림)
+    void readFrameBody(size_t length);
+
+    // 큰 프레임의 다음 조각 수신
+    void readFrameSlice();
+
+    // 받은 조각 넘기기 (리스너가 가득 차 있으면 잠시 후 다시 넘김)
+    void deliverFrameSlice();
+
+    // 수신된 프레임 넘기기 (프레임 리스너가 가득 차 있으면 false)
+    bool dispatchFrame();
+
+    // 넘기지 못한 프레임을 잠시 후 다시 넘기고 다음 프레임 수신
+    void deliverFrame();
+
+    // 수신된 메시지 처리
     void handleMessage();
 
-    // ƮƮ 
+    // 하트비트 시작
     void startHeartbeat();
 
-    // 翬 ó
+    // 기능 협상 요청 (압축, 바이너리 청크, 바이너리 제어 메시지)
+    void sendHello();
+
+    // 전송할 프레임 압축 (줄어들지 않으면 false)
+    bool compressFrame(const std::string& payload, std::string& compressed);
+
+    // 수신한 프레임 압축 해제
+    bool decompressFrame();
+
+    // 재연결 처리
     void handleReconnect();
 
+    // 연결 끊김 처리 (재연결 시도)
+    void handleConnectionLost();
+
+    // 소켓을 닫고 연결 상태 초기화 (보내지 못한 메시지와 업로드는 다음 연결에서 보냄)
+    void closeConnection();
+
     boost::asio::io_context& io_context_;
     boost::asio::ip::tcp::socket socket_;
+    boost::asio::ssl::context tls_context_;
+    std::unique_ptr<boost::asio::ssl::stream<boost::asio::ip::tcp::socket&>> tls_stream_; // TLS 사용 시에만 생성
+    SSL_SESSION* tls_session_; // 재연결 시 재사용할 세션 (TLS 1.3 세션 티켓)
+    bool tls_enabled_;
+    std::shared_ptr<ShmChannel> shm_channel_; // "shm://이름" 서버에 연결할 때만 생성
+    size_t max_transfers_; // 동시에 받을 수 있는 파일 수
     boost::asio::steady_timer heartbeat_timer_;
     boost::asio::steady_timer reconnect_timer_;
-    std::queue<std::string> write_queue_;
+    boost::asio::steady_timer pipeline_timer_; // 프레임 리스너가 가득 찼을 때 다시 넘길 때까지 대기
+    // 전송 대기 프레임
+    struct OutgoingFrame {
+        std::string payload; // 원본 JSON
+        std::string compressed; // 압축된 데이터 (압축하지 않았으면 비어 있음)
+        std::string control; // 바이너리 제어 메시지 (형식이 없는 메시지면 비어 있음)
+        uint32_t header; // 길이 + 플래그 (big endian)
+    };
+
+    // 전송할 프레임 준비
+    static void makeFrame(const Json::Value& message, OutgoingFrame& frame);
+
+    // 보내는 중인 업로드
+    struct Upload {
+        uint32_t transfer_id; // 업로드 ID (클라이언트가 정함)
+        std::shared_ptr<const UploadFile> file;
+        uint64_t offset; // 다음에 보낼 위치
+        uint32_t crc; // 보낸 부분의 CRC32C
+        bool announced; // 이번 연결에서 upload_start 를 보냈는지
+    };
+
+    std::queue<OutgoingFrame> write_queue_;
+    std::deque<Upload> uploads_; // write_queue_ 가 비어 있을 때 차례로 전송
+    uint32_t last_upload_id_;
     std::mutex write_mutex_;
+    bool write_in_progress_;
+    bool write_scheduled_; // io 스레드에 전송 시작을 넘겼는지
     std::function<void(const Json::Value&)> on_receive_;
     std::function<void()> on_connect_;
     std::function<void()> on_disconnect_;
     std::function<void(size_t)> on_send_complete_;
+    std::function<void(const BinaryChunkHeader&, const char*, size_t)> on_binary_chunk_;
+    std::function<bool(uint32_t, std::vector<char>&)> on_frame_;
+    std::function<bool(uint32_t, size_t)> on_frame_slice_accept_;
+    std::function<bool(const FrameSlice&, std::vector<char>&)> on_frame_slice_;
     std::atomic<bool> connected_;
     int reconnect_attempts_;
     uint32_t message_length_;
+    uint32_t message_flags_;
     std::vector<char> message_buffer_;
+    std::vector<char> slice_buffer_; // 조각으로 받는 프레임의 현재 조각
+    size_t slice_frame_size_; // 조각으로 받는 프레임의 본문 크기
+    size_t slice_offset_; // 현재 조각의 본문 안 위치
+    std::vector<char> decompress_buffer_; // 압축 해제용 버퍼 (재사용)
+    std::atomic<bool> compression_enabled_;
+    std::atomic<bool> stripes_supported_;
+    std::atomic<bool> uploads_supported_;
+    std::atomic<bool> binary_control_enabled_; // 제어 메시지를 바이너리 형식으로 주고받는지 (hello_ack 로 협상)
+    std::atomic<uint64_t> raw_bytes_sent_;
+    std::atomic<uint64_t> wire_bytes_sent_;
+    std::atomic<uint64_t> raw_bytes_received_;
+    std::atomic<uint64_t> wire_bytes_received_;
+    std::atomic<uint64_t> compress_time_us_;
+    std::atomic<uint64_t> decompress_time_us_;
+    std::atomic<uint64_t> receive_busy_us_;
+    FrameRecorder recorder_;
+    std::atomic<bool> recording_;
     std::string current_host_;
     int current_port_;
+    std::vector<ServerEndpoint> endpoints_; // 연결할 서버 목록
+    size_t active_endpoint_; // 연결 중이거나 연결을 시도하는 서버
+    std::shared_ptr<EndpointMonitor> endpoint_monitor_; // 서버가 여러 개일 때만 생성
+    bool endpoint_selected_; // 첫 프로브 라운드로 서버를 골랐는지
+    int degraded_rounds_; // 연결한 서버가 연속으로 느렸던 프로브 라운드 수
+    int64_t connect_started_; // 연결 구간 기록용 (Profiler)
+    std::chrono::steady_clock::time_point connect_time_; // 연결 시도 시각 (연결 시간 로그용)
 
     static const int MAX_RECONNECT_ATTEMPTS = 5;
     static const int RECONNECT_DELAY_MS = 5000;
+    static const int FAILOVER_DELAY_MS = 50; // 다른 서버로 옮기기 전 대기 (닫은 연결의 남은 완료 핸들러가 먼저 끝나도록)
+    static const int FAILED_PROBES = 2; // 연결한 서버의 프로브가 연속으로 이만큼 실패하면 옮김
+    static const int DEGRADED_RTT_RATIO = 3; // 연결한 서버의 왕복 시간이 다른 서버의 이 배수 + DEGRADED_RTT_MARGIN_MS 보다 길면 느린 것으로 판단
+    static const int DEGRADED_RTT_MARGIN_MS = 20;
+    static const int DEGRADED_ROUNDS = 3; // 이만큼 연속으로 느리면 옮김 (일시적인 지연으로 오가지 않도록)
     static const int HEARTBEAT_INTERVAL_MS = 10000;
-    static const size_t MAX_MESSAGE_SIZE = 100 * 1024 * 1024;
+    static const int PIPELINE_RETRY_MS = 1;
+    static const size_t STREAM_SLICE_SIZE = 1024 * 1024; // 이보다 큰 프레임은 이 크기씩 나눠 읽음
+    static const size_t UPLOAD_CHUNK_SIZE = 256 * 1024; // 업로드 청크 크기
+    static const size_t UPLOAD_SEND_BUDGET = 1024 * 1024; // 한 번에 보내는 업로드 데이터 (제어 메시지가 기다리는 최대 분량)
 };
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// 단일 생산자/단일 소비자 고정 크기 큐 (잠금 없음)
+// 슬롯을 제자리에서 채우고 비우므로 슬롯 안의 버퍼는 계속 재사용됨
+template <typename T>
+class SpscQueue {
+public:
+    // capacity 는 2의 거듭제곱으로 올림
+    explicit SpscQueue(size_t capacity) : head_(0), tail_(0) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    // 생산자: 채울 슬롯 (가득 차 있으면 nullptr), 채운 뒤 publish()
+    T* acquire() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    // 생산자: acquire() 로 받은 슬롯을 소비자에게 넘김
+    void publish() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+    }
+
+    // 소비자: 가장 오래된 슬롯 (비어 있으면 nullptr), 다 쓰면 release()
+    T* front() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_seq_cst)) {
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    // 소비자: front() 로 받은 슬롯을 생산자에게 돌려줌
+    void release() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_seq_cst) == tail_.load(std::memory_order_seq_cst);
+    }
+
+    bool full() const {
+        return tail_.load(std::memory_order_seq_cst) - head_.load(std::memory_order_seq_cst) > mask_;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_; // 소비자가 다음에 읽을 위치
+    alignas(64) std::atomic<size_t> tail_; // 생산자가 다음에 쓸 위치
+};
@@ -0,0 +1,364 @@
+#include "pch.h"
+#include "StripedDownloader.h"
+#include "Crc32c.h"
+#include <algorithm>
+#include <iostream>
+
+// 생성자
+std::shared_ptr<StripedDownloader> StripedDownloader::create(boost::asio::io_context& io_context, FileManager& file_manager) {
+    return std::shared_ptr<StripedDownloader>(new StripedDownloader(io_context, file_manager));
+}
+
+StripedDownloader::StripedDownloader(boost::asio::io_context& io_context, FileManager& file_manager) : io_context_(io_context),
+    file_manager_(file_manager),
+    goodput_timer_(io_context),
+    port_(0),
+    transfer_id_(0),
+    prefix_size_(0),
+    prefix_crc_(0),
+    next_segment_(0),
+    baseline_goodput_(0),
+    settling_(false),
+    growing_(false),
+    running_(false) {}
+
+// 소멸자
+StripedDownloader::~StripedDownloader() {
+    stop();
+}
+
+// 다운로드 시작
+bool StripedDownloader::start(const std::string& host, int port, uint32_t transferId, const std::string& fileName, size_t fileSize) {
+
+    if (running_) {
+        return false;
+    }
+
+    // 이미 받은 앞부분 다음부터 나눠 받음
+    if (!file_manager_.getReceivedPrefix(transferId, prefix_size_, prefix_crc_) || prefix_size_ >= fileSize) {
+        return false;
+    }
+
+    host_ = host;
+    port_ = port;
+    transfer_id_ = transferId;
+    file_name_ = fileName;
+
+    segments_.clear();
+    for (size_t offset = prefix_size_; offset < fileSize; offset += SEGMENT_SIZE) {
+        Segment segment;
+        segment.offset = offset;
+        segment.length = (std::min)(SEGMENT_SIZE, fileSize - offset);
+        segment.done = false;
+        segment.crc = 0;
+        segments_.push_back(segment);
+    }
+
+    next_segment_ = 0;
+    retry_segments_.clear();
+    pending_repairs_.clear();
+    baseline_goodput_ = 0;
+    settling_ = false;
+    growing_ = true;
+    running_ = true;
+
+    // 구간마다 제자리에 기록하도록 전체 크기를 미리 확보
+    file_manager_.preallocateFile(transfer_id_);
+
+    std::cout << "구간 다운로드 시작: " << file_name_ << " (" << segments_.size() << "개 구간)" << std::endl;
+
+    for (size_t i = 0; i < INITIAL_STRIPES; i++) {
+        addStripe();
+    }
+    scheduleGoodputCheck();
+    return true;
+}
+
+// 중단
+void StripedDownloader::stop() {
+
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    goodput_timer_.cancel();
+
+    // 연결의 리스너는 Stripe 를 약한 참조로 잡고 있으므로 목록에서 빼면 더 이상 호출되지 않음
+    std::vector<std::shared_ptr<Stripe>> stripes;
+    stripes.swap(stripes_);
+    for (auto& stripe : stripes) {
+        stripe->socket->disconnect();
+    }
+}
+
+// 진행 중인 전송인지
+bool StripedDownloader::isDownloading(uint32_t transferId) const {
+    return running_ && transfer_id_ == transferId;
+}
+
+// 완료 이벤트 리스너 설정
+void StripedDownloader::setOnCompleteListener(std::function<void(const std::string&, bool)> listener) {
+    on_complete_ = listener;
+}
+
+// 연결 추가
+void StripedDownloader::addStripe() {
+
+    std::shared_ptr<Stripe> stripe = std::make_shared<Stripe>();
+    stripe->socket = SocketManager::create(io_context_);
+
+    std::weak_ptr<StripedDownloader> weak_self = shared_from_this();
+    std::weak_ptr<Stripe> weak_stripe = stripe;
+
+    stripe->socket->setOnConnectListener([weak_self, weak_stripe]() {
+        auto self = weak_self.lock();
+        auto stripe = weak_stripe.lock();
+        if (self && stripe && self->running_) {
+            self->requestSegments(*stripe);
+        }
+        });
+
+    stripe->socket->setOnDisconnectListener([weak_self, weak_stripe]() {
+        auto self = weak_self.lock();
+        auto stripe = weak_stripe.lock();
+        if (self && stripe && self->running_) {
+            self->releaseSegments(*stripe);
+        }
+        });
+
+    stripe->socket->setOnReceiveListener([weak_self, weak_stripe](const Json::Value& message) {
+        auto self = weak_self.lock();
+        auto stripe = weak_stripe.lock();
+        if (self && stripe && self->running_) {
+            self->handleMessage(*stripe, message);
+        }
+        });
+
+    stripe->socket->setOnBinaryChunkListener([weak_self, weak_stripe](const BinaryChunkHeader& header, const char* data, size_t size) {
+        auto self = weak_self.lock();
+        auto stripe = weak_stripe.lock();
+        if (self && stripe && self->running_ && header.transfer_id == self->transfer_id_) {
+            self->handleChunk(*stripe, data, size, static_cast<size_t>(header.offset), header.crc);
+        }
+        });
+
+    stripes_.push_back(stripe);
+    stripe->socket->connect(host_, port_);
+}
+
+// 연결에 구간 요청
+void StripedDownloader::requestSegments(Stripe& stripe) {
+
+    while (stripe.requested.size() < PIPELINE_DEPTH) {
+
+        size_t index;
+        if (!retry_segments_.empty()) {
+            index = retry_segments_.front();
+            retry_segments_.pop_front();
+        }
+        else if (next_segment_ < segments_.size()) {
+            index = next_segment_++;
+        }
+        else {
+            return;
+        }
+
+        const Segment& segment = segments_[index];
+
+        Json::Value content;
+        content["transfer_id"] = transfer_id_.load();
+        content["filename"] = file_name_;
+        content["offset"] = static_cast<Json::UInt64>(segment.offset);
+        content["length"] = static_cast<Json::UInt64>(segment.length);
+
+        Json::Value json_message;
+        json_message["type"] = "stripe_request";
+        json_message["content"] = content;
+        stripe.socket->send(json_message);
+
+        stripe.requested.push_back(index);
+    }
+}
+
+// 끝나지 않은 구간 되돌리기
+void StripedDownloader::releaseSegments(Stripe& stripe) {
+
+    for (size_t index : stripe.requested) {
+        retry_segments_.push_back(index);
+    }
+    stripe.requested.clear();
+
+    // 다른 연결이 바로 가져가도록
+    for (auto& other : stripes_) {
+        if (other.get() != &stripe && other->socket->isConnected()) {
+            requestSegments(*other);
+        }
+    }
+}
+
+// 수신한 메시지 처리
+void StripedDownloader::handleMessage(Stripe& stripe, const Json::Value& message) {
+
+    std::string type = message["type"].asString();
+    const Json::Value& content = message["content"];
+
+    if (type == "stripe_end") {
+
+        handleStripeEnd(stripe, content);
+    }
+    else if (type == "file_chunk" && content.isObject() && content["transfer_id"].asUInt() == transfer_id_) {
+
+        // 손상 구간 재전송 (JSON 청크)
+        ChunkRange badRange;
+        size_t offset = content["offset"].asUInt64();
+        if (!file_manager_.appendFileChunk(transfer_id_, content["data"].asString(), offset, content["crc"].asUInt(), badRange)) {
+            requestRange(stripe, badRange);
+            return;
+        }
+        pending_repairs_.erase(offset);
+        tryFinish();
+    }
+}
+
+// 청크 수신
+void StripedDownloader::handleChunk(Stripe& stripe, const char* data, size_t size, size_t offset, uint32_t crc) {
+
+    ChunkRange badRange;
+    if (!file_manager_.appendRawChunk(transfer_id_, data, size, offset, crc, badRange)) {
+        requestRange(stripe, badRange);
+        return;
+    }
+
+    stripe.received_bytes += size;
+    if (pending_repairs_.erase(offset) > 0) {
+        tryFinish();
+    }
+}
+
+// 구간 하나 완료
+void StripedDownloader::handleStripeEnd(Stripe& stripe, const Json::Value& content) {
+
+    if (content["transfer_id"].asUInt() != transfer_id_) {
+        return;
+    }
+
+    size_t offset = content["offset"].asUInt64();
+    if (offset < prefix_size_) {
+        return;
+    }
+
+    size_t index = (offset - prefix_size_) / SEGMENT_SIZE;
+    if (index >= segments_.size() || segments_[index].offset != offset) {
+        return;
+    }
+
+    segments_[index].done = true;
+    segments_[index].crc = content["crc"].asUInt();
+
+    auto it = std::find(stripe.requested.begin(), stripe.requested.end(), index);
+    if (it != stripe.requested.end()) {
+        stripe.requested.erase(it);
+    }
+
+    requestSegments(stripe);
+    tryFinish();
+}
+
+// 손상된 청크 다시 요청
+void StripedDownloader::requestRange(Stripe& stripe, const ChunkRange& range) {
+
+    pending_repairs_.insert(range.offset);
+
+    Json::Value content;
+    content["transfer_id"] = transfer_id_.load();
+    content["filename"] = file_name_;
+    content["offset"] = static_cast<Json::UInt64>(range.offset);
+    content["length"] = static_cast<Json::UInt64>(range.length);
+
+    Json::Value json_message;
+    json_message["type"] = "range_request";
+    json_message["content"] = content;
+    stripe.socket->send(json_message);
+}
+
+// goodput 측정 예약
+void StripedDownloader::scheduleGoodputCheck() {
+
+    std::weak_ptr<StripedDownloader> weak_self = shared_from_this();
+    goodput_timer_.expires_after(std::chrono::seconds(1));
+    goodput_timer_.async_wait([weak_self](const boost::system::error_code& ec) {
+        auto self = weak_self.lock();
+        if (!ec && self && self->running_) {
+            self->checkGoodput();
+            self->scheduleGoodputCheck();
+        }
+        });
+}
+
+// 연결별 goodput 을 재서 연결 수 조절
+void StripedDownloader::checkGoodput() {
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < stripes_.size(); i++) {
+        Stripe& stripe = *stripes_[i];
+        uint64_t goodput = stripe.received_bytes - stripe.last_received_bytes;
+        stripe.last_received_bytes = stripe.received_bytes;
+        total += goodput;
+
+        std::cout << "구간 연결 " << i << ": " << goodput / 1024 << " KB/s" << std::endl;
+    }
+
+    bool remaining = next_segment_ < segments_.size();
+    if (!growing_ || !remaining || stripes_.size() >= MAX_STRIPES) {
+        return;
+    }
+
+    // 방금 연 연결이 자리 잡는 동안은 판단하지 않음
+    if (settling_) {
+        settling_ = false;
+        return;
+    }
+
+    // 연결을 늘려도 전체 goodput 이 10% 이상 늘지 않으면 더 늘리지 않음
+    if (baseline_goodput_ > 0 && total < baseline_goodput_ + baseline_goodput_ / 10) {
+        growing_ = false;
+        std::cout << "구간 연결 수 확정: " << stripes_.size() << "개 (" << total / 1024 << " KB/s)" << std::endl;
+        return;
+    }
+
+    baseline_goodput_ = total;
+    settling_ = true;
+    addStripe();
+}
+
+// 모든 구간을 받았으면 저장
+void StripedDownloader::tryFinish() {
+
+    for (const Segment& segment : segments_) {
+        if (!segment.done) {
+            return;
+        }
+    }
+
+    if (!pending_repairs_.empty()) {
+        return;
+    }
+
+    // 서버가 읽은 구간 CRC 를 이어 붙인 값이 전체 파일 CRC
+    uint32_t file_crc = prefix_crc_;
+    for (const Segment& segment : segments_) {
+        file_crc = Crc32c::combine(file_crc, segment.crc, segment.length);
+    }
+
+    bool saved = file_manager_.finishFileDownload(transfer_id_, file_crc);
+    std::string file_name = file_name_;
+
+    std::cout << "구간 다운로드 " << (saved ? "완료: " : "실패: ") << file_name << std::endl;
+
+    stop();
+
+    if (on_complete_) {
+        on_complete_(file_name, saved);
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "SocketManager.h"
+#include "FileManager.h"
+#include <boost/asio.hpp>
+#include <json/json.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// 큰 파일 하나를 구간으로 나눠 여러 연결로 동시에 받기
+// (모든 연결이 같은 io_context 스레드에서 실행되므로 잠금 없음)
+class StripedDownloader : public std::enable_shared_from_this<StripedDownloader> {
+public:
+    // 생성자
+    static std::shared_ptr<StripedDownloader> create(boost::asio::io_context& io_context, FileManager& file_manager);
+    ~StripedDownloader();
+
+    // 다운로드 시작 (file_manager 에 transferId 로 시작된 전송의 나머지 구간을 받음)
+    bool start(const std::string& host, int port, uint32_t transferId, const std::string& fileName, size_t fileSize);
+
+    // 중단 (받은 부분은 FileManager 가 이어받기용으로 유지)
+    void stop();
+
+    // 진행 중인 전송인지
+    bool isDownloading(uint32_t transferId) const;
+
+    // 완료 이벤트 리스너 설정 (저장되면 true)
+    void setOnCompleteListener(std::function<void(const std::string&, bool)> listener);
+
+    static const size_t MIN_FILE_SIZE = 32 * 1024 * 1024; // 이보다 큰 파일만 나눠 받음
+    static const size_t SEGMENT_SIZE = 4 * 1024 * 1024; // 한 번에 요청하는 구간 크기
+    static const size_t INITIAL_STRIPES = 2; // 처음 여는 연결 수
+    static const size_t MAX_STRIPES = 8; // 최대 연결 수
+    static const size_t PIPELINE_DEPTH = 2; // 연결마다 미리 요청해 두는 구간 수
+
+private:
+    explicit StripedDownloader(boost::asio::io_context& io_context, FileManager& file_manager);
+
+    // 받을 구간
+    struct Segment {
+        size_t offset; // 시작 위치
+        size_t length; // 길이
+        bool done; // stripe_end 수신 여부
+        uint32_t crc; // 서버가 알려준 구간 CRC32C
+    };
+
+    // 연결 하나
+    struct Stripe {
+        std::shared_ptr<SocketManager> socket;
+        std::deque<size_t> requested; // 요청하고 아직 끝나지 않은 구간 번호
+        uint64_t received_bytes = 0; // 검증된 바이트
+        uint64_t last_received_bytes = 0; // 직전 측정 시점의 received_bytes
+    };
+
+    // 연결 추가
+    void addStripe();
+
+    // 연결에 구간 요청 (PIPELINE_DEPTH 만큼 채움)
+    void requestSegments(Stripe& stripe);
+
+    // 연결 끊김: 끝나지 않은 구간을 다른 연결이 받도록 되돌림
+    void releaseSegments(Stripe& stripe);
+
+    // 수신 처리
+    void handleMessage(Stripe& stripe, const Json::Value& message);
+    void handleChunk(Stripe& stripe, const char* data, size_t size, size_t offset, uint32_t crc);
+    void handleStripeEnd(Stripe& stripe, const Json::Value& content);
+
+    // 손상된 청크 다시 요청
+    void requestRange(Stripe& stripe, const ChunkRange& range);
+
+    // 1초마다 연결별 goodput 을 재서 연결 수 조절
+    void scheduleGoodputCheck();
+    void checkGoodput();
+
+    // 모든 구간을 받았으면 전체 CRC 검증 후 저장
+    void tryFinish();
+
+    boost::asio::io_context& io_context_;
+    FileManager& file_manager_;
+    boost::asio::steady_timer goodput_timer_;
+    std::string host_;
+    int port_;
+    std::atomic<uint32_t> transfer_id_; // 쓰기 스레드에서도 isDownloading 으로 읽음
+    std::string file_name_;
+    size_t prefix_size_; // 시작할 때 이미 받아 둔 앞부분 크기
+    uint32_t prefix_crc_; // 앞부분의 CRC32C
+    std::vector<Segment> segments_;
+    size_t next_segment_; // 아직 요청하지 않은 첫 구간
+    std::deque<size_t> retry_segments_; // 끊긴 연결에서 되돌려진 구간
+    std::set<size_t> pending_repairs_; // 다시 요청한 손상 구간 (위치)
+    std::vector<std::shared_ptr<Stripe>> stripes_;
+    uint64_t baseline_goodput_; // 마지막으로 연결을 늘리기 전의 전체 goodput
+    bool settling_; // 새 연결이 자리 잡는 중
+    bool growing_; // 연결을 더 늘릴지
+    std::atomic<bool> running_;
+    std::function<void(const std::string&, bool)> on_complete_;
+};
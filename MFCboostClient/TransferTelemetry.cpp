@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "TransferTelemetry.h"
+#include <algorithm>
+
+const double TransferTelemetry::SMOOTHING = 0.3;
+
+// 생성자
+TransferTelemetry::TransferTelemetry() : requested_(false), stall_threshold_(std::chrono::milliseconds(STALL_THRESHOLD_MS)) {}
+
+// 파일을 요청한 시각 기록
+void TransferTelemetry::markRequest() {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    request_time_ = Clock::now();
+    requested_ = true;
+}
+
+// 전송 시작
+void TransferTelemetry::startTransfer(uint32_t transferId, const std::string& fileName, size_t fileSize, size_t offset) {
+
+    Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[transferId];
+    entry = Entry();
+    entry.file_name = fileName;
+    entry.file_size = fileSize;
+    entry.received = offset;
+    entry.request_time = requested_ ? request_time_ : now;
+    entry.last_chunk_time = now;
+    entry.window_start = now;
+}
+
+// 받은 파일 데이터 반영
+void TransferTelemetry::addBytes(uint32_t transferId, size_t bytes) {
+
+    Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(transferId);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    markArrival(entry, now);
+
+    entry.received += bytes;
+    entry.window_bytes += bytes;
+
+    // 구간이 끝났으면 속도 갱신
+    Clock::duration elapsed = now - entry.window_start;
+    if (elapsed >= std::chrono::milliseconds(SAMPLE_INTERVAL_MS)) {
+        entry.goodput = entry.window_bytes / std::chrono::duration<double>(elapsed).count();
+        entry.smoothed_goodput = entry.smoothed_goodput > 0 ? entry.smoothed_goodput + SMOOTHING * (entry.goodput - entry.smoothed_goodput) : entry.goodput;
+        entry.window_bytes = 0;
+        entry.window_start = now;
+    }
+}
+
+// 검증 전 데이터 도착 반영
+void TransferTelemetry::markActivity(uint32_t transferId) {
+
+    Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(transferId);
+    if (it != entries_.end()) {
+        markArrival(it->second, now);
+    }
+}
+
+// 전송 끝
+void TransferTelemetry::finishTransfer(uint32_t transferId) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(transferId);
+}
+
+// 모든 전송 끝
+void TransferTelemetry::clear() {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+// 진행 중인 전송 목록
+std::vector<TransferStats> TransferTelemetry::getStats() const {
+
+    Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TransferStats> stats;
+    stats.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        stats.push_back(makeStats(entry.first, entry.second, now));
+    }
+    return stats;
+}
+
+// 멈춤 판정 시간
+void TransferTelemetry::setStallThreshold(std::chrono::milliseconds threshold) {
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stall_threshold_ = threshold;
+}
+
+// 멈춤 이벤트 리스너 설정
+void TransferTelemetry::setOnStallListener(std::function<void(const TransferStats&)> listener) {
+    on_stall_ = listener;
+}
+
+// 멈춘 전송 확인
+void TransferTelemetry::checkStalls() {
+
+    Clock::time_point now = Clock::now();
+    std::vector<TransferStats> stalled;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : entries_) {
+            if (!entry.second.stalled && now - entry.second.last_chunk_time >= stall_threshold_) {
+                entry.second.stalled = true;
+                stalled.push_back(makeStats(entry.first, entry.second, now));
+            }
+        }
+    }
+
+    // 리스너는 잠금 밖에서 호출 (리스너가 getStats 를 불러도 됨)
+    if (on_stall_) {
+        for (const auto& stats : stalled) {
+            on_stall_(stats);
+        }
+    }
+}
+
+// 데이터 도착 시각 갱신
+void TransferTelemetry::markArrival(Entry& entry, Clock::time_point now) {
+
+    if (!entry.first_byte) {
+        entry.first_byte = true;
+        entry.first_byte_time = now;
+        entry.window_start = now;
+    }
+
+    entry.last_chunk_time = now;
+    entry.stalled = false;
+}
+
+// 측정값을 통계로 변환
+TransferStats TransferTelemetry::makeStats(uint32_t transferId, const Entry& entry, Clock::time_point now) {
+
+    TransferStats stats;
+    stats.transferId = transferId;
+    stats.fileName = entry.file_name;
+    stats.fileSize = entry.file_size;
+    stats.receivedBytes = entry.received;
+    stats.goodput = entry.goodput;
+    stats.smoothedGoodput = entry.smoothed_goodput;
+    stats.idleSeconds = std::chrono::duration<double>(now - entry.last_chunk_time).count();
+    stats.firstByteSeconds = entry.first_byte ? std::chrono::duration<double>(entry.first_byte_time - entry.request_time).count() : -1;
+    stats.stalled = entry.stalled;
+
+    // 구간이 끝나지 않은 채로 청크가 끊기면 지금까지의 평균으로 낮춤
+    double window = std::chrono::duration<double>(now - entry.window_start).count();
+    if (entry.first_byte && window * 1000 >= SAMPLE_INTERVAL_MS) {
+        stats.goodput = (std::min)(stats.goodput, entry.window_bytes / window);
+    }
+
+    size_t remaining = entry.file_size > entry.received ? entry.file_size - entry.received : 0;
+    stats.etaSeconds = stats.smoothedGoodput > 0 ? remaining / stats.smoothedGoodput : -1;
+    return stats;
+}
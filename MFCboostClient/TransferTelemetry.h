@@ -0,0 +1,96 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 받는 중인 파일 하나의 진행 상황
+struct TransferStats {
+    uint32_t transferId; // 전송 ID
+    std::string fileName; // 파일 이름
+    size_t fileSize; // 파일의 총 크기
+    size_t receivedBytes; // 받은 크기 (이어받기 시작 위치 포함)
+    double goodput; // 최근 구간의 속도 (바이트/초)
+    double smoothedGoodput; // 지수 이동 평균 속도 (바이트/초)
+    double etaSeconds; // 남은 시간 (속도를 모르면 -1)
+    double idleSeconds; // 마지막 청크 이후 시간 (아직 받지 않았으면 시작 이후)
+    double firstByteSeconds; // 요청부터 첫 청크까지 (아직이면 -1)
+    bool stalled; // 멈춤으로 판정됨
+};
+
+// 전송별 속도, 남은 시간, 멈춤 감지 (여러 스레드에서 호출해도 됨)
+// 청크마다 addBytes 를 호출하는 쪽은 잠금 한 번과 시계 읽기만 하고, 계산은 getStats/checkStalls 를 부르는 쪽에서 함
+class TransferTelemetry {
+public:
+    TransferTelemetry();
+
+    // 파일을 요청한 시각 기록 (이후 시작하는 전송의 첫 바이트 시간 기준)
+    void markRequest();
+
+    // 전송 시작 (offset 은 이어받기 시작 위치)
+    void startTransfer(uint32_t transferId, const std::string& fileName, size_t fileSize, size_t offset);
+
+    // 받은 파일 데이터 반영 (검증을 마친 데이터만)
+    void addBytes(uint32_t transferId, size_t bytes);
+
+    // 검증 전 데이터가 도착하는 중임을 반영 (받은 크기는 그대로 두고 멈춤 판정만 미룸)
+    void markActivity(uint32_t transferId);
+
+    // 전송 끝 (완료, 실패, 중단)
+    void finishTransfer(uint32_t transferId);
+
+    // 모든 전송 끝
+    void clear();
+
+    // 진행 중인 전송 목록
+    std::vector<TransferStats> getStats() const;
+
+    // 멈춤 판정 시간 (기본 STALL_THRESHOLD_MS)
+    void setStallThreshold(std::chrono::milliseconds threshold);
+
+    // 멈춤 이벤트 리스너 설정 (checkStalls 를 호출한 스레드에서 호출)
+    void setOnStallListener(std::function<void(const TransferStats&)> listener);
+
+    // 멈춘 전송 확인 (주기적으로 호출, 새로 멈춘 전송마다 리스너 호출)
+    void checkStalls();
+
+    static const int SAMPLE_INTERVAL_MS = 250; // 속도를 계산하는 구간
+    static const int STALL_THRESHOLD_MS = 5000;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // 전송 하나의 측정값
+    struct Entry {
+        std::string file_name;
+        size_t file_size = 0;
+        size_t received = 0; // 받은 크기
+        Clock::time_point request_time; // 요청 시각 (첫 바이트 시간 기준)
+        Clock::time_point first_byte_time;
+        Clock::time_point last_chunk_time; // 아직 받지 않았으면 시작 시각
+        Clock::time_point window_start; // 현재 속도 구간 시작
+        size_t window_bytes = 0; // 현재 속도 구간에 받은 크기
+        double goodput = 0; // 마지막으로 끝난 구간의 속도
+        double smoothed_goodput = 0;
+        bool first_byte = false; // 첫 청크를 받았는지
+        bool stalled = false;
+    };
+
+    // 데이터 도착 시각 갱신 (mutex_ 를 잡은 상태에서 호출)
+    static void markArrival(Entry& entry, Clock::time_point now);
+
+    // 측정값을 통계로 변환
+    static TransferStats makeStats(uint32_t transferId, const Entry& entry, Clock::time_point now);
+
+    std::map<uint32_t, Entry> entries_; // 진행 중인 전송 (전송 ID -> 측정값)
+    Clock::time_point request_time_; // 마지막 요청 시각
+    bool requested_; // 요청한 적이 있는지
+    Clock::duration stall_threshold_;
+    std::function<void(const TransferStats&)> on_stall_;
+    mutable std::mutex mutex_; // entries_ 와 요청 시각 보호
+
+    static const double SMOOTHING; // 지수 이동 평균 가중치
+};
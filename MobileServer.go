@@ -1,10 +1,12 @@
 package main
 
 import (
+	"crypto/tls"
 	"encoding/base64"
 	"encoding/binary"
 	"encoding/json"
 	"errors"
+	"hash/crc32"
 	"io"
 	"log"
 	"net"
@@ -12,6 +14,7 @@ import (
 	"path/filepath"
 	"runtime"
 	"sync"
+	"sync/atomic"
 	"time"
 )
 
@@ -23,13 +26,30 @@ const (
 	jobQueueSize     = 1000
 	filesDir         = "./files"
 	maxFileSize      = 100 * 1024 * 1024 // 최대 파일 크기를 100MB로 줄임
+
+	frameCompressedFlag = 0x80000000 // 길이 최상위 비트: LZ4 압축 프레임
+	minCompressSize     = 256        // 이보다 작은 프레임은 압축하지 않음
+	maxMessageSize      = 100 * 1024 * 1024
+	maxTransfersLimit   = 16 // 클라이언트가 더 많이 요청해도 이 수까지만
+
+	tlsAddress  = ":51112"     // TLS 포트 (인증서가 있을 때만 사용)
+	tlsCertFile = "server.crt" // 자체 서명 인증서로 테스트 가능
+	tlsKeyFile  = "server.key"
 )
 
+var castagnoliTable = crc32.MakeTable(crc32.Castagnoli)
+
+// 전송 ID (file_start/file_chunk/file_end에 실어서 여러 파일의 청크를 구분)
+var lastTransferID uint32
+
 type Client struct {
 	conn           net.Conn
 	id             string
 	lastSeen       time.Time
-	networkQuality float64 // 0.0 (최악) ~ 1.0 (최상)
+	networkQuality float64    // 0.0 (최악) ~ 1.0 (최상)
+	writeMu        sync.Mutex // 여러 고루틴의 메시지가 섞이지 않도록 보호
+	compression    bool       // LZ4 프레임 압축 사용 여부 (writeMu로 보호)
+	maxTransfers   int        // 동시에 보낼 파일 수 (hello로 협상)
 }
 
 type Server struct {
@@ -90,6 +110,12 @@ func handleJob(job Job) {
 	case "filerequest":
 		log.Printf("클라이언트 %s로부터 파일 요청 받음", job.clientID)
 		sendFilesToClient(job.clientID)
+	case "resume":
+		log.Printf("클라이언트 %s로부터 이어받기 요청 받음", job.clientID)
+		resumeFileToClient(job.clientID, job.message.Content)
+	case "range_request":
+		log.Printf("클라이언트 %s로부터 구간 재전송 요청 받음", job.clientID)
+		sendFileRangeToClient(job.clientID, job.message.Content)
 	default:
 		log.Printf("알 수 없는 작업 타입: %s", job.message.Type)
 	}
@@ -112,6 +138,7 @@ func main() {
 	log.Printf("서버 시작: %s", listener.Addr().String())
 
 	go server.monitorStats()
+	go server.serveTLS()
 
 	for {
 		conn, err := listener.Accept()
@@ -124,6 +151,38 @@ func main() {
 	}
 }
 
+// 인증서가 있으면 TLS 포트도 연다. Go는 TLS 1.3 세션 티켓을 기본으로 발급하므로
+// 클라이언트가 재연결할 때 세션 재사용(1-RTT)이 가능하다.
+func (s *Server) serveTLS() {
+	cert, err := tls.LoadX509KeyPair(tlsCertFile, tlsKeyFile)
+	if err != nil {
+		log.Printf("TLS 비활성화 (인증서 없음): %v", err)
+		return
+	}
+
+	listener, err := tls.Listen("tcp", tlsAddress, &tls.Config{
+		Certificates: []tls.Certificate{cert},
+		MinVersion:   tls.VersionTLS12,
+	})
+	if err != nil {
+		log.Printf("TLS 네트워크 오류: %v", err)
+		return
+	}
+	defer listener.Close()
+
+	log.Printf("TLS 서버 시작: %s", listener.Addr().String())
+
+	for {
+		conn, err := listener.Accept()
+		if err != nil {
+			log.Printf("TLS 연결 수락 오류: %v", err)
+			continue
+		}
+
+		go s.handleConnection(conn)
+	}
+}
+
 func NewServer() *Server {
 	return &Server{
 		workerPool: NewWorkerPool(numWorkers, jobQueueSize),
@@ -137,6 +196,7 @@ func (s *Server) handleConnection(conn net.Conn) {
 		id:             conn.RemoteAddr().String(),
 		lastSeen:       time.Now(),
 		networkQuality: 1.0, // 초기 네트워크 품질을 최상으로 설정
+		maxTransfers:   1,
 	}
 
 	log.Printf("클라이언트 연결: %s", client.id)
@@ -162,10 +222,12 @@ func (s *Server) handleConnection(conn net.Conn) {
 
 		switch message.Type {
 		case "heartbeat":
-			err = sendMessage(conn, Message{Type: "heartbeat_ack"})
+			err = client.send(Message{Type: "heartbeat_ack"})
+		case "hello":
+			err = client.acceptHello(message.Content)
 		case "chat":
 			log.Printf("%s로부터 메시지 받음: %v", client.id, message.Content)
-		case "filerequest":
+		case "filerequest", "resume", "range_request":
 			job := Job{
 				clientID: client.id,
 				message:  message,
@@ -204,13 +266,26 @@ func readMessage(conn net.Conn) (Message, error) {
 		return Message{}, err
 	}
 
-	length := int(binary.BigEndian.Uint32(lengthBuf))
+	length := binary.BigEndian.Uint32(lengthBuf)
+	compressed := length&frameCompressedFlag != 0
+	length &^= frameCompressedFlag
+	if length > maxMessageSize {
+		return Message{}, errors.New("메시지 크기 초과")
+	}
+
 	messageBuf := make([]byte, length)
 	_, err = io.ReadFull(conn, messageBuf)
 	if err != nil {
 		return Message{}, err
 	}
 
+	if compressed {
+		messageBuf, err = decompressFrame(messageBuf)
+		if err != nil {
+			return Message{}, err
+		}
+	}
+
 	var message Message
 	err = json.Unmarshal(messageBuf, &message)
 	if err != nil {
@@ -220,13 +295,21 @@ func readMessage(conn net.Conn) (Message, error) {
 	return message, nil
 }
 
-func sendMessage(conn net.Conn, message Message) error {
+func sendMessage(conn net.Conn, message Message, compress bool) error {
 	jsonMessage, err := json.Marshal(message)
 	if err != nil {
 		return err
 	}
 
 	length := uint32(len(jsonMessage))
+	if compress && len(jsonMessage) >= minCompressSize {
+		// 줄어드는 경우에만 압축 프레임으로 전송
+		if compressed := compressFrame(jsonMessage); len(compressed) < len(jsonMessage) {
+			jsonMessage = compressed
+			length = uint32(len(jsonMessage)) | frameCompressedFlag
+		}
+	}
+
 	lengthBuf := make([]byte, 4)
 	binary.BigEndian.PutUint32(lengthBuf, length)
 
@@ -256,16 +339,109 @@ func sendFilesToClient(clientID string) {
 		return
 	}
 
+	// 클라이언트가 허용한 수만큼 여러 파일을 동시에 전송 (청크는 전송 ID로 구분)
+	slots := make(chan struct{}, getMaxTransfers(clientID))
+	var wg sync.WaitGroup
 	for _, file := range files {
 		if !file.IsDir() {
 			filePath := filepath.Join(filesDir, file.Name())
-			sendFileToClient(clientID, filePath)
+			slots <- struct{}{}
+			wg.Add(1)
+			go func() {
+				defer wg.Done()
+				sendFileToClient(clientID, filePath, 0, 0)
+				<-slots
+			}()
 		}
 	}
+	wg.Wait()
+}
+
+func getMaxTransfers(clientID string) int {
+	clientInterface, ok := server.clients.Load(clientID)
+	if !ok {
+		return 1
+	}
+	client, ok := clientInterface.(*Client)
+	if !ok {
+		return 1
+	}
+
+	client.writeMu.Lock()
+	defer client.writeMu.Unlock()
+	return client.maxTransfers
+}
+
+func resumeFileToClient(clientID string, content interface{}) {
+	request, ok := content.(map[string]interface{})
+	if !ok {
+		log.Printf("잘못된 이어받기 요청: %v", content)
+		return
+	}
+
+	fileName, _ := request["filename"].(string)
+	offset, _ := request["offset"].(float64)
+	crc, _ := request["crc"].(float64)
+
+	// 파일 이름에 경로가 포함되지 않도록 제한
+	fileName = filepath.Base(fileName)
+	if fileName == "." || fileName == string(filepath.Separator) {
+		log.Printf("잘못된 파일 이름: %v", request["filename"])
+		return
+	}
+
+	sendFileToClient(clientID, filepath.Join(filesDir, fileName), int64(offset), uint32(crc))
+}
+
+// CRC 불일치로 클라이언트가 다시 요청한 구간만 전송
+func sendFileRangeToClient(clientID string, content interface{}) {
+	request, ok := content.(map[string]interface{})
+	if !ok {
+		log.Printf("잘못된 구간 요청: %v", content)
+		return
+	}
+
+	fileName, _ := request["filename"].(string)
+	offset, _ := request["offset"].(float64)
+	length, _ := request["length"].(float64)
+	transferID, _ := request["transfer_id"].(float64)
+
+	fileName = filepath.Base(fileName)
+	if fileName == "." || fileName == string(filepath.Separator) || offset < 0 || length <= 0 || length > maxChunkSize {
+		log.Printf("잘못된 구간 요청: %v", request)
+		return
+	}
+
+	file, err := os.Open(filepath.Join(filesDir, fileName))
+	if err != nil {
+		log.Printf("파일 열기 오류: %v", err)
+		return
+	}
+	defer file.Close()
+
+	buf := make([]byte, int(length))
+	n, err := file.ReadAt(buf, int64(offset))
+	if err != nil && err != io.EOF {
+		log.Printf("파일 읽기 오류: %v", err)
+		return
+	}
+
+	if err := sendFileChunk(clientID, uint32(transferID), fileName, int64(offset), buf[:n]); err != nil {
+		log.Printf("청크 전송 오류: %v", err)
+	}
+}
+
+// 클라이언트가 받은 앞부분의 CRC32C가 일치하는지 확인
+func verifyPrefix(file *os.File, offset int64, crc uint32) bool {
+	hash := crc32.New(castagnoliTable)
+	if _, err := io.CopyN(hash, file, offset); err != nil {
+		return false
+	}
+	return hash.Sum32() == crc
 }
 
-func sendFileToClient(clientID, filePath string) {
-	log.Printf("클라이언트 %s에게 파일 전송 시작: %s", clientID, filePath)
+func sendFileToClient(clientID, filePath string, offset int64, crc uint32) {
+	log.Printf("클라이언트 %s에게 파일 전송 시작: %s (offset %d)", clientID, filePath, offset)
 
 	file, err := os.Open(filePath)
 	if err != nil {
@@ -285,11 +461,28 @@ func sendFileToClient(clientID, filePath string) {
 		return
 	}
 
-	sendStartMessage(clientID, fileInfo.Name(), fileInfo.Size())
+	// 이어받기 위치가 맞지 않으면 처음부터 다시 전송
+	if offset < 0 || offset > fileInfo.Size() || (offset > 0 && !verifyPrefix(file, offset, crc)) {
+		log.Printf("이어받기 위치 불일치, 처음부터 전송: %s", filePath)
+		offset = 0
+	}
+	if _, err := file.Seek(offset, io.SeekStart); err != nil {
+		log.Printf("파일 탐색 오류: %v", err)
+		return
+	}
+
+	transferID := atomic.AddUint32(&lastTransferID, 1)
+	sendStartMessage(clientID, transferID, fileInfo.Name(), fileInfo.Size(), offset)
+
+	// 전체 파일 CRC32C (이어받기면 확인된 앞부분의 CRC부터 누적)
+	fileCrc := uint32(0)
+	if offset > 0 {
+		fileCrc = crc
+	}
 
 	chunkSize := getChunkSize(clientID)
 	buf := make([]byte, chunkSize)
-	totalSent := int64(0)
+	totalSent := offset
 	for {
 		n, err := file.Read(buf)
 		if err != nil && err != io.EOF {
@@ -300,11 +493,12 @@ func sendFileToClient(clientID, filePath string) {
 			break
 		}
 
-		err = sendFileChunk(clientID, buf[:n])
+		err = sendFileChunk(clientID, transferID, fileInfo.Name(), totalSent, buf[:n])
 		if err != nil {
 			log.Printf("청크 전송 오류: %v", err)
 			return
 		}
+		fileCrc = crc32.Update(fileCrc, castagnoliTable, buf[:n])
 		totalSent += int64(n)
 		server.stats.addTransferredBytes(int64(n))
 
@@ -314,7 +508,7 @@ func sendFileToClient(clientID, filePath string) {
 		time.Sleep(calculateDelay(clientID))
 	}
 
-	sendEndMessage(clientID, fileInfo.Name())
+	sendEndMessage(clientID, transferID, fileInfo.Name(), fileCrc)
 	log.Printf("클라이언트 %s에게 파일 전송 완료: %s", clientID, filePath)
 }
 
@@ -354,30 +548,40 @@ func calculateDelay(clientID string) time.Duration {
 	return time.Duration(float64(baseDelay) / client.networkQuality)
 }
 
-func sendStartMessage(clientID, filename string, filesize int64) {
+func sendStartMessage(clientID string, transferID uint32, filename string, filesize int64, offset int64) {
 	message := Message{
 		Type: "file_start",
 		Content: map[string]interface{}{
-			"filename": filename,
-			"filesize": filesize,
+			"transfer_id": transferID,
+			"filename":    filename,
+			"filesize":    filesize,
+			"offset":      offset,
 		},
 	}
 	sendMessageToClient(clientID, message)
 }
 
-func sendFileChunk(clientID string, chunk []byte) error {
+func sendFileChunk(clientID string, transferID uint32, fileName string, offset int64, chunk []byte) error {
 	message := Message{
-		Type:    "file_chunk",
-		Content: base64.StdEncoding.EncodeToString(chunk),
+		Type: "file_chunk",
+		Content: map[string]interface{}{
+			"transfer_id": transferID,
+			"filename":    fileName,
+			"offset":      offset,
+			"crc":         crc32.Checksum(chunk, castagnoliTable),
+			"data":        base64.StdEncoding.EncodeToString(chunk),
+		},
 	}
 	return sendMessageToClient(clientID, message)
 }
 
-func sendEndMessage(clientID string, fileName string) {
+func sendEndMessage(clientID string, transferID uint32, fileName string, fileCrc uint32) {
 	message := Message{
 		Type: "file_end",
 		Content: map[string]interface{}{
-			"filename": fileName,
+			"transfer_id": transferID,
+			"filename":    fileName,
+			"crc":         fileCrc,
 		},
 	}
 	sendMessageToClient(clientID, message)
@@ -393,7 +597,212 @@ func sendMessageToClient(clientID string, message Message) error {
 		return errors.New("잘못된 클라이언트 타입")
 	}
 
-	return sendMessage(client.conn, message)
+	return client.send(message)
+}
+
+func (c *Client) send(message Message) error {
+	c.writeMu.Lock()
+	defer c.writeMu.Unlock()
+	return sendMessage(c.conn, message, c.compression)
+}
+
+// 기능 협상: 클라이언트가 lz4를 지원하면 이후 프레임을 압축, 동시 전송 수 결정
+func (c *Client) acceptHello(content interface{}) error {
+	compression := ""
+	maxTransfers := 1
+	if request, ok := content.(map[string]interface{}); ok {
+		if codecs, ok := request["compression"].([]interface{}); ok {
+			for _, codec := range codecs {
+				if codec == "lz4" {
+					compression = "lz4"
+				}
+			}
+		}
+		// 여러 파일의 청크를 섞어 받을 수 있는 클라이언트만 동시 전송
+		if transfers, ok := request["max_transfers"].(float64); ok && transfers > 1 {
+			maxTransfers = int(transfers)
+			if maxTransfers > maxTransfersLimit {
+				maxTransfers = maxTransfersLimit
+			}
+		}
+	}
+
+	c.writeMu.Lock()
+	defer c.writeMu.Unlock()
+
+	err := sendMessage(c.conn, Message{
+		Type: "hello_ack",
+		Content: map[string]interface{}{
+			"compression":   compression,
+			"max_transfers": maxTransfers,
+		},
+	}, false)
+	c.compression = err == nil && compression == "lz4"
+	c.maxTransfers = maxTransfers
+	log.Printf("클라이언트 %s 프레임 압축: %q", c.id, compression)
+	return err
+}
+
+// 압축 프레임: [원본 크기 4바이트 big endian][LZ4 블록]
+func compressFrame(src []byte) []byte {
+	dst := make([]byte, 4, 4+len(src))
+	binary.BigEndian.PutUint32(dst, uint32(len(src)))
+	return lz4CompressBlock(src, dst)
+}
+
+func decompressFrame(src []byte) ([]byte, error) {
+	if len(src) < 4 {
+		return nil, errors.New("잘못된 압축 프레임")
+	}
+	size := binary.BigEndian.Uint32(src)
+	if size > maxMessageSize {
+		return nil, errors.New("메시지 크기 초과")
+	}
+	return lz4DecompressBlock(src[4:], int(size))
+}
+
+// LZ4 블록 압축 (단순 해시 방식, 표준 LZ4 블록 형식과 호환)
+func lz4CompressBlock(src, dst []byte) []byte {
+	const (
+		minMatch     = 4
+		hashLog      = 12
+		mfLimit      = 12 // 마지막 일치는 끝에서 12바이트 전에 시작해야 함
+		lastLiterals = 5  // 마지막 5바이트는 항상 리터럴
+	)
+
+	var table [1 << hashLog]int // 위치 + 1
+	anchor := 0
+	n := len(src)
+
+	for i := 0; i+mfLimit <= n; {
+		seq := binary.LittleEndian.Uint32(src[i:])
+		h := (seq * 2654435761) >> (32 - hashLog)
+		ref := table[h] - 1
+		table[h] = i + 1
+
+		if ref < 0 || i-ref > 65535 || binary.LittleEndian.Uint32(src[ref:]) != seq {
+			i++
+			continue
+		}
+
+		matchLen := minMatch
+		for i+matchLen < n-lastLiterals && src[ref+matchLen] == src[i+matchLen] {
+			matchLen++
+		}
+
+		dst = lz4AppendSequence(dst, src[anchor:i], i-ref, matchLen-minMatch)
+		i += matchLen
+		anchor = i
+	}
+
+	return lz4AppendSequence(dst, src[anchor:], 0, -1)
+}
+
+// 시퀀스 기록 (matchLen < 0 이면 마지막 리터럴)
+func lz4AppendSequence(dst, literals []byte, offset, matchLen int) []byte {
+	var token byte
+	if len(literals) >= 15 {
+		token = 15 << 4
+	} else {
+		token = byte(len(literals)) << 4
+	}
+	if matchLen >= 15 {
+		token |= 15
+	} else if matchLen > 0 {
+		token |= byte(matchLen)
+	}
+
+	dst = append(dst, token)
+	dst = lz4AppendLength(dst, len(literals))
+	dst = append(dst, literals...)
+
+	if matchLen < 0 {
+		return dst
+	}
+
+	dst = append(dst, byte(offset), byte(offset>>8))
+	return lz4AppendLength(dst, matchLen)
+}
+
+// 15 이상인 길이의 추가 바이트 기록
+func lz4AppendLength(dst []byte, length int) []byte {
+	if length < 15 {
+		return dst
+	}
+	length -= 15
+	for length >= 255 {
+		dst = append(dst, 255)
+		length -= 255
+	}
+	return append(dst, byte(length))
+}
+
+// LZ4 블록 압축 해제
+func lz4DecompressBlock(src []byte, size int) ([]byte, error) {
+	errCorrupt := errors.New("손상된 LZ4 블록")
+	dst := make([]byte, 0, size)
+
+	readLength := func(i int, length int) (int, int, error) {
+		if length != 15 {
+			return i, length, nil
+		}
+		for {
+			if i >= len(src) {
+				return i, 0, errCorrupt
+			}
+			b := src[i]
+			i++
+			length += int(b)
+			if b != 255 {
+				return i, length, nil
+			}
+		}
+	}
+
+	for i := 0; i < len(src); {
+		token := src[i]
+		i++
+
+		var literalLen int
+		var err error
+		if i, literalLen, err = readLength(i, int(token>>4)); err != nil {
+			return nil, err
+		}
+		if i+literalLen > len(src) || len(dst)+literalLen > size {
+			return nil, errCorrupt
+		}
+		dst = append(dst, src[i:i+literalLen]...)
+		i += literalLen
+
+		// 마지막 시퀀스는 리터럴만 있음
+		if i == len(src) {
+			break
+		}
+		if i+2 > len(src) {
+			return nil, errCorrupt
+		}
+		offset := int(src[i]) | int(src[i+1])<<8
+		i += 2
+
+		var matchLen int
+		if i, matchLen, err = readLength(i, int(token&15)); err != nil {
+			return nil, err
+		}
+		matchLen += 4
+		if offset == 0 || offset > len(dst) || len(dst)+matchLen > size {
+			return nil, errCorrupt
+		}
+
+		start := len(dst) - offset
+		for k := 0; k < matchLen; k++ {
+			dst = append(dst, dst[start+k])
+		}
+	}
+
+	if len(dst) != size {
+		return nil, errCorrupt
+	}
+	return dst, nil
 }
 
 func (s *Stats) incrementActiveConnections() {
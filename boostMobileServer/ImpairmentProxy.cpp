@@ -0,0 +1,488 @@
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 네트워크 장애 재현용 TCP 프록시: 클라이언트와 서버 사이에서 지연, 지터, 대역폭 제한, 멈춤, 연결 끊기를 넣음
+// 사용법: ImpairmentProxy [수신 포트=52000] [서버 호스트=127.0.0.1] [서버 포트=51111] [프로파일 파일]
+//
+// 프로파일은 한 줄에 한 단계, 첫 연결부터의 시각(at=초)에 적용 (# 뒤는 주석)
+//   at=0 latency=40 jitter=10 bandwidth=512 queue=256   한 방향 지연(ms), ± 지터(ms), 방향별 대역폭(KB/s, 0=제한 없음), 방향별 연결당 버퍼(KB)
+//   at=10 stall=2000                                   2초 동안 양방향 전달 멈춤
+//   at=20 reset                                        모든 연결을 RST 로 끊음
+//   at=25 seed=7                                       지터 난수 시드 (같은 시드면 같은 지연)
+//   at=30 repeat                                       처음 단계부터 다시 (반복 주기 30초)
+// 1초마다 CSV 로 처리량을 출력 (LoadGenerator 의 초마다 출력과 같은 시간축)
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    // 링크 설정
+    struct LinkSettings {
+        int latency_ms = 0; // 한 방향 지연
+        int jitter_ms = 0; // 지연에 더하는 ± 무작위 값
+        uint64_t bandwidth = 0; // 방향별 대역폭 (바이트/초, 0 이면 제한 없음)
+        size_t queue_limit = 1024 * 1024; // 방향별 연결마다 쌓아 둘 최대 바이트 (넘으면 읽기를 멈춰 TCP 흐름 제어가 동작)
+    };
+
+    // 프로파일 한 단계 (음수는 바꾸지 않음)
+    struct ProfileStep {
+        double at = 0; // 첫 연결부터 초
+        int latency_ms = -1;
+        int jitter_ms = -1;
+        int64_t bandwidth_kbps = -1;
+        int64_t queue_kb = -1;
+        int stall_ms = 0;
+        int64_t seed = -1;
+        bool reset = false;
+        bool repeat = false;
+    };
+
+    // 프로파일 파일 읽기
+    bool loadProfile(const std::string& path, std::vector<ProfileStep>& steps) {
+
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "프로파일을 열 수 없습니다: " << path << std::endl;
+            return false;
+        }
+
+        std::string line;
+        int line_number = 0;
+        while (std::getline(file, line)) {
+
+            ++line_number;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream tokens(line);
+            std::string token;
+            ProfileStep step;
+            bool empty = true;
+
+            while (tokens >> token) {
+
+                empty = false;
+                size_t equal = token.find('=');
+                std::string key = token.substr(0, equal);
+                std::string value = equal == std::string::npos ? "" : token.substr(equal + 1);
+
+                if (key == "at") step.at = std::atof(value.c_str());
+                else if (key == "latency") step.latency_ms = std::atoi(value.c_str());
+                else if (key == "jitter") step.jitter_ms = std::atoi(value.c_str());
+                else if (key == "bandwidth") step.bandwidth_kbps = std::atoll(value.c_str());
+                else if (key == "queue") step.queue_kb = std::atoll(value.c_str());
+                else if (key == "stall") step.stall_ms = std::atoi(value.c_str());
+                else if (key == "seed") step.seed = std::atoll(value.c_str());
+                else if (key == "reset") step.reset = true;
+                else if (key == "repeat") step.repeat = true;
+                else {
+                    std::cerr << path << ":" << line_number << " 알 수 없는 항목: " << token << std::endl;
+                    return false;
+                }
+            }
+
+            if (!empty) {
+                steps.push_back(step);
+            }
+        }
+
+        std::stable_sort(steps.begin(), steps.end(), [](const ProfileStep& a, const ProfileStep& b) { return a.at < b.at; });
+        return true;
+    }
+
+    // 방향 하나의 링크 상태 (모든 연결이 대역폭을 나눠 씀)
+    struct Link {
+        Clock::time_point next_free = Clock::now(); // 대역폭 제한에서 다음 바이트를 보낼 수 있는 시각
+        uint64_t bytes = 0; // 전달한 바이트 (통계 출력마다 0 으로)
+    };
+
+    // 모든 연결이 함께 쓰는 상태 (io_context 스레드 하나에서만 사용)
+    struct ProxyState {
+        LinkSettings settings;
+        Link upstream; // 클라이언트 -> 서버
+        Link downstream; // 서버 -> 클라이언트
+        Clock::time_point stall_until = Clock::now();
+        std::mt19937 random{ 1 };
+
+        // 이번 조각의 지연
+        Clock::duration sampleDelay() {
+            int delay = settings.latency_ms;
+            if (settings.jitter_ms > 0) {
+                delay += std::uniform_int_distribution<int>(-settings.jitter_ms, settings.jitter_ms)(random);
+            }
+            return std::chrono::milliseconds(std::max(0, delay));
+        }
+    };
+
+    class ProxyConnection : public std::enable_shared_from_this<ProxyConnection> {
+    public:
+        ProxyConnection(boost::asio::ip::tcp::socket client, ProxyState& state)
+            : client_(std::move(client)), server_(client_.get_executor()), state_(state),
+            upstream_(client_, server_, state.upstream), downstream_(server_, client_, state.downstream), closed_(false) {}
+
+        // 서버에 연결하고 양방향 전달 시작
+        void start(const boost::asio::ip::tcp::resolver::results_type& endpoints) {
+
+            auto self(shared_from_this());
+            boost::asio::async_connect(server_, endpoints,
+                [this, self](boost::system::error_code ec, const boost::asio::ip::tcp::endpoint&) {
+                    if (ec) {
+                        std::cerr << "서버 연결 실패: " << ec.message() << std::endl;
+                        close();
+                        return;
+                    }
+
+                    boost::system::error_code option_ec;
+                    client_.set_option(boost::asio::ip::tcp::no_delay(true), option_ec);
+                    server_.set_option(boost::asio::ip::tcp::no_delay(true), option_ec);
+
+                    startRead(upstream_);
+                    startRead(downstream_);
+                });
+        }
+
+        // 양쪽 모두 RST 로 끊음 (재연결 동작 확인용)
+        void reset() {
+
+            boost::system::error_code ec;
+            client_.set_option(boost::asio::socket_base::linger(true, 0), ec);
+            server_.set_option(boost::asio::socket_base::linger(true, 0), ec);
+            close();
+        }
+
+        bool isClosed() const {
+            return closed_;
+        }
+
+    private:
+        // 지연을 거쳐 전달할 조각
+        struct Segment {
+            std::vector<char> data;
+            Clock::time_point release; // 보낼 수 있는 시각
+        };
+
+        // 한 방향의 전달 상태
+        struct Pipe {
+            Pipe(boost::asio::ip::tcp::socket& source, boost::asio::ip::tcp::socket& target, Link& link)
+                : from(source), to(target), link(link), timer(source.get_executor()) {}
+
+            boost::asio::ip::tcp::socket& from;
+            boost::asio::ip::tcp::socket& to;
+            Link& link;
+            boost::asio::steady_timer timer; // 지연, 대역폭, 멈춤 대기
+            std::array<char, 16 * 1024> buffer;
+            std::deque<Segment> queue;
+            size_t queued_bytes = 0;
+            Clock::time_point last_release = Clock::now(); // TCP 순서를 지키도록 앞 조각보다 먼저 보내지 않음
+            bool reading = false;
+            bool writing = false;
+            bool eof = false; // 보내는 쪽이 연결을 닫음
+        };
+
+        // 읽기 (버퍼가 가득 차면 멈췄다가 보낸 뒤 다시 시작)
+        void startRead(Pipe& pipe) {
+
+            if (closed_ || pipe.reading || pipe.eof || pipe.queued_bytes >= state_.settings.queue_limit) {
+                return;
+            }
+
+            // 대역폭 제한이 있으면 작은 조각으로 나눠 약 10ms 단위로 내보냄
+            size_t size = pipe.buffer.size();
+            if (state_.settings.bandwidth > 0) {
+                size = std::min(size, std::max<size_t>(1460, static_cast<size_t>(state_.settings.bandwidth / 100)));
+            }
+
+            pipe.reading = true;
+            auto self(shared_from_this());
+            pipe.from.async_read_some(boost::asio::buffer(pipe.buffer.data(), size),
+                [this, self, &pipe](boost::system::error_code ec, std::size_t length) {
+
+                    pipe.reading = false;
+                    if (closed_) {
+                        return;
+                    }
+
+                    if (ec) {
+                        if (ec != boost::asio::error::eof) {
+                            close();
+                            return;
+                        }
+                        pipe.eof = true;
+                        if (pipe.queue.empty()) {
+                            boost::system::error_code shutdown_ec;
+                            pipe.to.shutdown(boost::asio::ip::tcp::socket::shutdown_send, shutdown_ec);
+                        }
+                        return;
+                    }
+
+                    Segment segment;
+                    segment.data.assign(pipe.buffer.data(), pipe.buffer.data() + length);
+                    segment.release = std::max(Clock::now() + state_.sampleDelay(), pipe.last_release);
+                    pipe.last_release = segment.release;
+                    pipe.queued_bytes += length;
+                    pipe.queue.push_back(std::move(segment));
+
+                    startWrite(pipe);
+                    startRead(pipe);
+                });
+        }
+
+        // 지연과 대역폭을 반영한 시각에 앞 조각 전송
+        void startWrite(Pipe& pipe) {
+
+            if (closed_ || pipe.writing || pipe.queue.empty()) {
+                return;
+            }
+
+            pipe.writing = true;
+            const Segment& segment = pipe.queue.front();
+            Clock::time_point send_at = std::max(segment.release, state_.stall_until);
+
+            // 모든 연결이 같은 방향의 대역폭을 차례로 나눠 씀
+            if (state_.settings.bandwidth > 0) {
+                send_at = std::max(send_at, pipe.link.next_free);
+                pipe.link.next_free = send_at + std::chrono::nanoseconds(segment.data.size() * 1000000000ull / state_.settings.bandwidth);
+            }
+
+            waitAndSend(pipe, send_at);
+        }
+
+        // 보낼 시각까지 기다린 뒤 전송 (기다리는 동안 멈춤이 시작되면 멈춤이 끝날 때까지 더 기다림)
+        void waitAndSend(Pipe& pipe, Clock::time_point send_at) {
+
+            auto self(shared_from_this());
+            send_at = std::max(send_at, state_.stall_until);
+            if (send_at > Clock::now()) {
+                pipe.timer.expires_at(send_at);
+                pipe.timer.async_wait([this, self, &pipe](boost::system::error_code ec) {
+                    if (!ec && !closed_) {
+                        waitAndSend(pipe, Clock::now());
+                    }
+                    });
+                return;
+            }
+
+            boost::asio::async_write(pipe.to, boost::asio::buffer(pipe.queue.front().data),
+                [this, self, &pipe](boost::system::error_code ec, std::size_t length) {
+
+                    if (ec || closed_) {
+                        close();
+                        return;
+                    }
+
+                    pipe.link.bytes += length;
+                    pipe.queued_bytes -= length;
+                    pipe.queue.pop_front();
+                    pipe.writing = false;
+
+                    if (pipe.eof && pipe.queue.empty()) {
+                        boost::system::error_code shutdown_ec;
+                        pipe.to.shutdown(boost::asio::ip::tcp::socket::shutdown_send, shutdown_ec);
+                    }
+
+                    startWrite(pipe);
+                    startRead(pipe);
+                });
+        }
+
+        // 연결 종료
+        void close() {
+
+            if (closed_) {
+                return;
+            }
+
+            closed_ = true;
+            boost::system::error_code ec;
+            upstream_.timer.cancel();
+            downstream_.timer.cancel();
+            client_.close(ec);
+            server_.close(ec);
+        }
+
+        boost::asio::ip::tcp::socket client_;
+        boost::asio::ip::tcp::socket server_;
+        ProxyState& state_;
+        Pipe upstream_;
+        Pipe downstream_;
+        bool closed_;
+    };
+
+    class ImpairmentProxy {
+    public:
+        ImpairmentProxy(boost::asio::io_context& io_context, unsigned short port, const boost::asio::ip::tcp::resolver::results_type& endpoints, const std::vector<ProfileStep>& steps)
+            : io_context_(io_context), acceptor_(io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)),
+            endpoints_(endpoints), steps_(steps), step_timer_(io_context), stats_timer_(io_context), next_step_(0), started_(false) {}
+
+        // 연결 수락과 통계 출력 시작
+        void start() {
+
+            std::cout << "time_s,connections,down_KBps,up_KBps,latency_ms,jitter_ms,bandwidth_KBps" << std::endl;
+            doAccept();
+            scheduleStats();
+        }
+
+    private:
+        void doAccept() {
+
+            acceptor_.async_accept([this](boost::system::error_code ec, boost::asio::ip::tcp::socket socket) {
+
+                if (!ec) {
+
+                    // 프로파일 시간은 첫 연결부터 (부하 생성기를 늦게 띄워도 같은 곡선)
+                    if (!started_) {
+                        started_ = true;
+                        profile_start_ = Clock::now();
+                        cycle_start_ = profile_start_;
+                        scheduleStep();
+                    }
+
+                    auto connection = std::make_shared<ProxyConnection>(std::move(socket), state_);
+                    connection->start(endpoints_);
+                    connections_.push_back(connection);
+                }
+
+                doAccept();
+                });
+        }
+
+        // 다음 프로파일 단계 예약
+        void scheduleStep() {
+
+            if (next_step_ >= steps_.size()) {
+                return;
+            }
+
+            step_timer_.expires_at(cycle_start_ + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(steps_[next_step_].at)));
+            step_timer_.async_wait([this](boost::system::error_code ec) {
+                if (!ec) {
+                    applyStep(steps_[next_step_]);
+                    scheduleStep();
+                }
+                });
+        }
+
+        // 프로파일 단계 적용
+        void applyStep(const ProfileStep& step) {
+
+            if (step.repeat) {
+                cycle_start_ += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(step.at));
+                next_step_ = 0;
+                return;
+            }
+            ++next_step_;
+
+            LinkSettings& settings = state_.settings;
+            if (step.latency_ms >= 0) settings.latency_ms = step.latency_ms;
+            if (step.jitter_ms >= 0) settings.jitter_ms = step.jitter_ms;
+            if (step.bandwidth_kbps >= 0) settings.bandwidth = static_cast<uint64_t>(step.bandwidth_kbps) * 1024;
+            if (step.queue_kb >= 0) settings.queue_limit = std::max<size_t>(1, static_cast<size_t>(step.queue_kb) * 1024);
+            if (step.seed >= 0) state_.random.seed(static_cast<std::mt19937::result_type>(step.seed));
+
+            // 대역폭이 바뀌면 이전 설정으로 예약한 시간은 버림
+            state_.upstream.next_free = std::min(state_.upstream.next_free, Clock::now());
+            state_.downstream.next_free = std::min(state_.downstream.next_free, Clock::now());
+
+            if (step.stall_ms > 0) {
+                state_.stall_until = std::max(state_.stall_until, Clock::now() + std::chrono::milliseconds(step.stall_ms));
+            }
+
+            if (step.reset) {
+                for (auto& weak : connections_) {
+                    if (auto connection = weak.lock()) {
+                        connection->reset();
+                    }
+                }
+            }
+
+            std::cerr << "프로파일 " << elapsedSeconds() << "초: 지연 " << settings.latency_ms << "±" << settings.jitter_ms << " ms, 대역폭 "
+                << (settings.bandwidth ? std::to_string(settings.bandwidth / 1024) + " KB/s" : "제한 없음")
+                << (step.stall_ms > 0 ? ", 멈춤 " + std::to_string(step.stall_ms) + " ms" : "")
+                << (step.reset ? ", 연결 끊기" : "") << std::endl;
+        }
+
+        // 1초마다 처리량 출력
+        void scheduleStats() {
+
+            stats_timer_.expires_after(std::chrono::seconds(1));
+            stats_timer_.async_wait([this](boost::system::error_code ec) {
+                if (ec) {
+                    return;
+                }
+
+                connections_.erase(std::remove_if(connections_.begin(), connections_.end(), [](const std::weak_ptr<ProxyConnection>& weak) {
+                    auto connection = weak.lock();
+                    return !connection || connection->isClosed();
+                    }), connections_.end());
+
+                if (started_) {
+                    const LinkSettings& settings = state_.settings;
+                    std::cout << elapsedSeconds() << "," << connections_.size() << ","
+                        << state_.downstream.bytes / 1024.0 << "," << state_.upstream.bytes / 1024.0 << ","
+                        << settings.latency_ms << "," << settings.jitter_ms << "," << settings.bandwidth / 1024 << std::endl;
+                }
+
+                state_.downstream.bytes = 0;
+                state_.upstream.bytes = 0;
+                scheduleStats();
+                });
+        }
+
+        double elapsedSeconds() const {
+            return std::chrono::duration<double>(Clock::now() - profile_start_).count();
+        }
+
+        boost::asio::io_context& io_context_;
+        boost::asio::ip::tcp::acceptor acceptor_;
+        boost::asio::ip::tcp::resolver::results_type endpoints_;
+        std::vector<ProfileStep> steps_;
+        ProxyState state_;
+        std::vector<std::weak_ptr<ProxyConnection>> connections_;
+        boost::asio::steady_timer step_timer_;
+        boost::asio::steady_timer stats_timer_;
+        size_t next_step_;
+        bool started_; // 첫 연결을 받았는지
+        Clock::time_point profile_start_;
+        Clock::time_point cycle_start_; // 현재 반복 주기의 시작
+    };
+}
+
+int main(int argc, char* argv[]) {
+
+    unsigned short port = argc > 1 ? static_cast<unsigned short>(std::atoi(argv[1])) : 52000;
+    std::string host = argc > 2 ? argv[2] : "127.0.0.1";
+    std::string server_port = argc > 3 ? argv[3] : "51111";
+
+    std::vector<ProfileStep> steps;
+    if (argc > 4 && !loadProfile(argv[4], steps)) {
+        return 1;
+    }
+
+    try {
+        boost::asio::io_context io_context;
+        boost::asio::ip::tcp::resolver resolver(io_context);
+        auto endpoints = resolver.resolve(host, server_port);
+
+        ImpairmentProxy proxy(io_context, port, endpoints, steps);
+        proxy.start();
+
+        std::cerr << "프록시 시작: :" << port << " -> " << host << ":" << server_port << " (프로파일 " << steps.size() << "단계)" << std::endl;
+        io_context.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "네트워크 오류: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,413 @@
+#include "FrameCodec.h"
+#include "ShmChannel.h"
+#include <boost/asio.hpp>
+#include <json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 서버 부하 테스트: 여러 클라이언트로 접속해서 전체 파일을 계속 요청
+// 사용법: LoadGenerator [호스트=127.0.0.1] [포트=51111] [클라이언트 수=100] [시간(초)=10] [바이너리 청크=1] [동시 전송 수=1] [초마다 출력=0]
+// 호스트를 shm://이름 으로 주면 같은 컴퓨터의 서버에 공유 메모리로 연결 (포트는 무시, 루프백 TCP 와 비교용)
+// 연결이 끊기면 1초 뒤 다시 연결 (ImpairmentProxy 의 연결 끊기 단계)
+
+namespace {
+
+    struct LoadStats {
+        std::atomic<uint64_t> bytes{ 0 }; // 받은 바이트
+        std::atomic<uint64_t> files{ 0 }; // 받은 파일 수
+        std::atomic<uint64_t> connect_failures{ 0 }; // 연결 실패
+        std::atomic<uint64_t> rtt_count{ 0 }; // heartbeat 응답 수
+        std::atomic<uint64_t> rtt_total_us{ 0 }; // heartbeat 왕복 시간 합
+        std::atomic<uint64_t> rtt_max_us{ 0 }; // heartbeat 최대 왕복 시간
+        std::atomic<uint64_t> interval_rtt_max_us{ 0 }; // 초마다 출력 사이의 heartbeat 최대 왕복 시간
+        std::atomic<uint64_t> reconnects{ 0 }; // 끊긴 뒤 다시 연결한 횟수
+        std::atomic<uint64_t> last_file_us{ 0 }; // 시작부터 마지막 파일을 받을 때까지 걸린 시간
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    };
+
+    class LoadClient : public std::enable_shared_from_this<LoadClient> {
+    public:
+        LoadClient(boost::asio::io_context& io_context, LoadStats& stats, bool binary, unsigned max_transfers, const std::string& shm_name)
+            : io_context_(io_context), socket_(io_context), timer_(io_context), stats_(stats), binary_(binary), max_transfers_(max_transfers), header_(0), flags_(0), shm_name_(shm_name), connected_(false), stopped_(false) {}
+
+        // 연결 시작
+        void start(const boost::asio::ip::tcp::resolver::results_type& endpoints) {
+
+            endpoints_ = endpoints;
+            connect();
+        }
+
+        // 연결 종료
+        void stop() {
+            stopped_ = true;
+            timer_.cancel();
+            closeTransport();
+        }
+
+    private:
+        void connect() {
+
+            auto self(shared_from_this());
+
+            // 공유 메모리 서버는 연결할 때마다 새 채널
+            if (!shm_name_.empty()) {
+                shm_channel_ = ShmChannel::create(io_context_);
+                shm_channel_->asyncConnect(shm_name_, [this, self](const boost::system::error_code& ec) {
+                    handleConnect(ec);
+                    });
+                return;
+            }
+
+            boost::asio::async_connect(socket_, endpoints_,
+                [this, self](boost::system::error_code ec, const boost::asio::ip::tcp::endpoint&) {
+                    handleConnect(ec);
+                });
+        }
+
+        void handleConnect(const boost::system::error_code& ec) {
+
+            if (ec) {
+                stats_.connect_failures++;
+                // 처음 연결에 실패하면 포기, 끊긴 뒤 다시 연결하는 중이면 계속 시도
+                if (connected_) {
+                    scheduleReconnect();
+                }
+                return;
+            }
+
+            if (connected_) {
+                stats_.reconnects++;
+            }
+            connected_ = true;
+            write_queue_.clear();
+
+            Json::Value hello;
+            hello["type"] = "hello";
+            hello["content"]["compression"].append("lz4");
+            hello["content"]["binary_chunks"] = binary_;
+            hello["content"]["max_transfers"] = max_transfers_;
+            send(hello);
+
+            Json::Value request;
+            request["type"] = "filerequest";
+            send(request);
+
+            doReadHeader();
+            scheduleHeartbeat();
+        }
+
+        bool isOpen() const {
+            return shm_channel_ ? shm_channel_->isOpen() : socket_.is_open();
+        }
+
+        void closeTransport() {
+
+            if (shm_channel_) {
+                shm_channel_->close();
+                return;
+            }
+
+            boost::system::error_code ec;
+            socket_.close(ec);
+        }
+
+        // 소켓 또는 공유 메모리로 읽기/쓰기
+        template <typename MutableBuffers, typename Handler>
+        void asyncRead(const MutableBuffers& buffers, Handler&& handler) {
+
+            if (shm_channel_) {
+                shm_channel_->asyncRead({ boost::asio::mutable_buffer(buffers) }, std::forward<Handler>(handler));
+            }
+            else {
+                boost::asio::async_read(socket_, buffers, std::forward<Handler>(handler));
+            }
+        }
+
+        template <typename ConstBuffers, typename Handler>
+        void asyncWrite(const ConstBuffers& buffers, Handler&& handler) {
+
+            if (shm_channel_) {
+                shm_channel_->asyncWrite({ boost::asio::const_buffer(buffers) }, std::forward<Handler>(handler));
+            }
+            else {
+                boost::asio::async_write(socket_, buffers, std::forward<Handler>(handler));
+            }
+        }
+
+        // 연결이 끊기면 1초 뒤 다시 연결
+        void handleDisconnect() {
+
+            if (stopped_ || !isOpen()) {
+                return;
+            }
+
+            closeTransport();
+            timer_.cancel();
+            scheduleReconnect();
+        }
+
+        void scheduleReconnect() {
+
+            if (stopped_) {
+                return;
+            }
+
+            auto self(shared_from_this());
+            timer_.expires_after(std::chrono::seconds(1));
+            timer_.async_wait([this, self](boost::system::error_code ec) {
+                if (!ec && !stopped_) {
+                    connect();
+                }
+                });
+        }
+
+        // 메시지 전송 (압축하지 않음)
+        void send(const Json::Value& message) {
+
+            Json::FastWriter writer;
+            std::string body = writer.write(message);
+            uint32_t header = FrameCodec::encodeHeader(body.size(), 0);
+
+            std::string frame(reinterpret_cast<const char*>(&header), sizeof(uint32_t));
+            frame += body;
+            write_queue_.push_back(std::move(frame));
+
+            if (write_queue_.size() == 1) {
+                doWrite();
+            }
+        }
+
+        void doWrite() {
+
+            auto self(shared_from_this());
+            asyncWrite(boost::asio::buffer(write_queue_.front()),
+                [this, self](boost::system::error_code ec, std::size_t) {
+                    if (ec) {
+                        handleDisconnect();
+                        return;
+                    }
+                    write_queue_.pop_front();
+                    if (!write_queue_.empty()) {
+                        doWrite();
+                    }
+                });
+        }
+
+        // 1초마다 heartbeat 로 왕복 시간 측정
+        void scheduleHeartbeat() {
+
+            auto self(shared_from_this());
+            timer_.expires_after(std::chrono::seconds(1));
+            timer_.async_wait([this, self](boost::system::error_code ec) {
+                if (ec) {
+                    return;
+                }
+                heartbeat_sent_ = std::chrono::steady_clock::now();
+                Json::Value heartbeat;
+                heartbeat["type"] = "heartbeat";
+                send(heartbeat);
+                scheduleHeartbeat();
+                });
+        }
+
+        void doReadHeader() {
+
+            auto self(shared_from_this());
+            asyncRead(boost::asio::buffer(&header_, sizeof(uint32_t)),
+                [this, self](boost::system::error_code ec, std::size_t) {
+                    if (ec) {
+                        handleDisconnect();
+                        return;
+                    }
+
+                    size_t length;
+                    FrameCodec::decodeHeader(header_, length, flags_);
+                    if (length > FrameCodec::MAX_MESSAGE_SIZE) {
+                        handleDisconnect();
+                        return;
+                    }
+
+                    body_.resize(length);
+                    doReadBody();
+                });
+        }
+
+        void doReadBody() {
+
+            auto self(shared_from_this());
+            asyncRead(boost::asio::buffer(body_),
+                [this, self](boost::system::error_code ec, std::size_t length) {
+                    if (ec) {
+                        handleDisconnect();
+                        return;
+                    }
+
+                    stats_.bytes += length + sizeof(uint32_t);
+
+                    // 바이너리 청크는 내용만 세고 넘어감
+                    if (!(flags_ & FrameCodec::BINARY_CHUNK_FLAG)) {
+                        handleMessage();
+                    }
+
+                    doReadHeader();
+                });
+        }
+
+        void handleMessage() {
+
+            const std::vector<char>* payload = &body_;
+            if (flags_ & FrameCodec::COMPRESSED_FLAG) {
+                if (!FrameCodec::decompress(body_.data(), body_.size(), decompressed_)) {
+                    return;
+                }
+                payload = &decompressed_;
+            }
+
+            // file_chunk 는 파싱 비용이 크므로 type 만 확인
+            static const std::string file_end = "\"type\":\"file_end\"";
+            static const std::string heartbeat_ack = "\"type\":\"heartbeat_ack\"";
+
+            if (std::search(payload->begin(), payload->end(), file_end.begin(), file_end.end()) != payload->end()) {
+                stats_.files++;
+                stats_.last_file_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - stats_.start).count());
+            }
+            else if (std::search(payload->begin(), payload->end(), heartbeat_ack.begin(), heartbeat_ack.end()) != payload->end()) {
+                auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - heartbeat_sent_).count();
+                stats_.rtt_count++;
+                stats_.rtt_total_us += static_cast<uint64_t>(rtt);
+                uint64_t max = stats_.rtt_max_us;
+                while (static_cast<uint64_t>(rtt) > max && !stats_.rtt_max_us.compare_exchange_weak(max, static_cast<uint64_t>(rtt))) {
+                }
+                max = stats_.interval_rtt_max_us;
+                while (static_cast<uint64_t>(rtt) > max && !stats_.interval_rtt_max_us.compare_exchange_weak(max, static_cast<uint64_t>(rtt))) {
+                }
+            }
+        }
+
+        boost::asio::io_context& io_context_;
+        boost::asio::ip::tcp::socket socket_;
+        std::shared_ptr<ShmChannel> shm_channel_; // shm:// 호스트일 때만 사용
+        boost::asio::steady_timer timer_;
+        LoadStats& stats_;
+        bool binary_;
+        unsigned max_transfers_;
+        uint32_t header_;
+        uint32_t flags_;
+        std::vector<char> body_;
+        std::vector<char> decompressed_;
+        std::string shm_name_; // 비어 있으면 TCP
+        std::deque<std::string> write_queue_;
+        std::chrono::steady_clock::time_point heartbeat_sent_;
+        boost::asio::ip::tcp::resolver::results_type endpoints_;
+        bool connected_; // 한 번이라도 연결했는지
+        bool stopped_;
+    };
+
+    // 1초마다 처리량과 heartbeat 왕복 시간을 CSV 로 출력 (그래프용)
+    class IntervalReporter {
+    public:
+        IntervalReporter(boost::asio::io_context& io_context, LoadStats& stats)
+            : timer_(io_context), stats_(stats), last_bytes_(0), last_rtt_count_(0), last_rtt_total_us_(0), last_reconnects_(0) {}
+
+        void start() {
+            std::cout << "time_s,MBps,rtt_avg_ms,rtt_max_ms,files,reconnects" << std::endl;
+            schedule();
+        }
+
+    private:
+        void schedule() {
+
+            timer_.expires_after(std::chrono::seconds(1));
+            timer_.async_wait([this](boost::system::error_code ec) {
+                if (ec) {
+                    return;
+                }
+
+                uint64_t bytes = stats_.bytes;
+                uint64_t rtt_count = stats_.rtt_count;
+                uint64_t rtt_total_us = stats_.rtt_total_us;
+                uint64_t reconnects = stats_.reconnects;
+                uint64_t rtt_max_us = stats_.interval_rtt_max_us.exchange(0);
+
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - stats_.start).count();
+                uint64_t count = rtt_count - last_rtt_count_;
+                std::cout << elapsed << "," << (bytes - last_bytes_) / (1024.0 * 1024.0) << ","
+                    << (count ? (rtt_total_us - last_rtt_total_us_) / count / 1000.0 : 0.0) << ","
+                    << rtt_max_us / 1000.0 << "," << stats_.files << "," << reconnects - last_reconnects_ << std::endl;
+
+                last_bytes_ = bytes;
+                last_rtt_count_ = rtt_count;
+                last_rtt_total_us_ = rtt_total_us;
+                last_reconnects_ = reconnects;
+                schedule();
+                });
+        }
+
+        boost::asio::steady_timer timer_;
+        LoadStats& stats_;
+        uint64_t last_bytes_;
+        uint64_t last_rtt_count_;
+        uint64_t last_rtt_total_us_;
+        uint64_t last_reconnects_;
+    };
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string host = argc > 1 ? argv[1] : "127.0.0.1";
+    std::string port = argc > 2 ? argv[2] : "51111";
+    int clients = argc > 3 ? std::atoi(argv[3]) : 100;
+    int seconds = argc > 4 ? std::atoi(argv[4]) : 10;
+    bool binary = argc > 5 ? std::atoi(argv[5]) != 0 : true;
+    unsigned max_transfers = argc > 6 ? static_cast<unsigned>(std::atoi(argv[6])) : 1;
+    bool interval = argc > 7 && std::atoi(argv[7]) != 0;
+
+    boost::asio::io_context io_context;
+    LoadStats stats;
+
+    // shm:// 호스트는 주소를 찾지 않음
+    const std::string shm_scheme = "shm://";
+    std::string shm_name = host.compare(0, shm_scheme.size(), shm_scheme) == 0 ? host.substr(shm_scheme.size()) : "";
+
+    boost::asio::ip::tcp::resolver::results_type endpoints;
+    if (shm_name.empty()) {
+        boost::asio::ip::tcp::resolver resolver(io_context);
+        endpoints = resolver.resolve(host, port);
+    }
+
+    std::vector<std::shared_ptr<LoadClient>> load_clients;
+    for (int i = 0; i < clients; ++i) {
+        auto client = std::make_shared<LoadClient>(io_context, stats, binary, max_transfers, shm_name);
+        client->start(endpoints);
+        load_clients.push_back(client);
+    }
+
+    IntervalReporter reporter(io_context, stats);
+    if (interval) {
+        reporter.start();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    io_context.run_for(std::chrono::seconds(seconds));
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& client : load_clients) {
+        client->stop();
+    }
+
+    uint64_t rtt_count = stats.rtt_count;
+    std::cout << "클라이언트: " << clients << ", 시간: " << elapsed << "초" << std::endl;
+    std::cout << "처리량: " << (stats.bytes / (1024.0 * 1024.0) / elapsed) << " MB/s" << std::endl;
+    std::cout << "받은 파일: " << stats.files << " (마지막 파일까지 " << stats.last_file_us / 1000.0 << " ms), 연결 실패: " << stats.connect_failures << ", 다시 연결: " << stats.reconnects << std::endl;
+    std::cout << "heartbeat 왕복 평균: " << (rtt_count ? stats.rtt_total_us / rtt_count / 1000.0 : 0.0)
+        << " ms, 최대: " << stats.rtt_max_us / 1000.0 << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include "MobileServer.h"
+#include "Session.h"
+#include "Crc32c.h"
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    // 여러 acceptor 가 같은 포트에 bind 하도록 허용 (커널이 연결을 나눠 줌)
+    typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> reuse_port;
+}
+
+// 생성자
+MobileServer::MobileServer(unsigned short port, size_t threads, const std::string& files_dir, uint64_t rate_limit, const std::string& uploads_dir, const std::string& shm_name) : port_(port),
+    files_dir_(files_dir),
+    uploads_dir_(uploads_dir),
+    rate_limit_(rate_limit),
+    shm_name_(shm_name),
+    blocking_pool_(BLOCKING_THREADS),
+    active_connections_(0),
+    total_transferred_(0) {
+
+    boost::filesystem::create_directories(uploads_dir_);
+
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port);
+
+    for (size_t i = 0; i < threads; i++) {
+
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->acceptor.open(endpoint.protocol());
+        worker->acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+        worker->acceptor.set_option(reuse_port(true));
+        worker->acceptor.bind(endpoint);
+        worker->acceptor.listen(boost::asio::socket_base::max_listen_connections);
+        workers_.push_back(std::move(worker));
+    }
+
+    if (!shm_name_.empty()) {
+        shm_listener_.reset(new ShmListener(shm_name_));
+    }
+}
+
+// 서버 실행
+void MobileServer::run() {
+
+    std::cout << "서버 시작: :" << port_ << " (스레드 " << workers_.size() << "개)";
+    if (shm_listener_) {
+        std::cout << ", shm://" << shm_name_;
+    }
+    std::cout << std::endl;
+
+    std::vector<std::thread> threads;
+    for (auto& worker : workers_) {
+
+        startAccept(*worker);
+
+        Worker* w = worker.get();
+        threads.emplace_back([w]() {
+            w->io_context.run();
+            });
+    }
+
+    std::thread(&MobileServer::monitorStats, this).detach();
+
+    if (shm_listener_) {
+        std::thread(&MobileServer::acceptShm, this).detach();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// 연결 수락
+void MobileServer::startAccept(Worker& worker) {
+
+    worker.acceptor.async_accept([this, &worker](boost::system::error_code ec, boost::asio::ip::tcp::socket socket) {
+
+        if (!ec) {
+            std::make_shared<Session>(std::move(socket), *this)->start();
+        }
+        else {
+            std::cerr << "연결 수락 오류: " << ec.message() << std::endl;
+        }
+
+        startAccept(worker);
+        });
+}
+
+// 공유 메모리 연결 수락
+void MobileServer::acceptShm() {
+
+    size_t next = 0;
+    for (;;) {
+
+        std::string segment;
+        if (!shm_listener_->waitForConnection(segment, SHM_ACCEPT_WAIT_MS)) {
+            continue;
+        }
+
+        // TCP 연결처럼 세션은 배정한 스레드의 io_context 에서만 실행
+        Worker& worker = *workers_[next++ % workers_.size()];
+        std::shared_ptr<ShmChannel> channel = ShmChannel::create(worker.io_context);
+        if (!channel->accept(segment)) {
+            std::cerr << "공유 메모리 연결 수락 오류: " << segment << std::endl;
+            continue;
+        }
+
+        boost::asio::post(worker.io_context, [this, channel, &worker]() {
+            std::make_shared<Session>(channel, worker.io_context, *this)->start();
+            });
+    }
+}
+
+// 파일 폴더
+const std::string& MobileServer::getFilesDirectory() const {
+    return files_dir_;
+}
+
+// 업로드 받은 파일을 저장할 폴더
+const std::string& MobileServer::getUploadsDirectory() const {
+    return uploads_dir_;
+}
+
+// 연결당 파일 전송 속도 제한
+uint64_t MobileServer::getRateLimit() const {
+    return rate_limit_;
+}
+
+// 캐시된 청크별 CRC32C
+std::shared_ptr<const std::vector<uint32_t>> MobileServer::findChunkCrcs(const std::string& path, uint64_t size, int64_t mtime) {
+
+    std::lock_guard<std::mutex> lock(crc_cache_mutex_);
+    auto it = crc_cache_.find(path);
+    if (it != crc_cache_.end() && it->second.size == size && it->second.mtime == mtime) {
+        return it->second.crcs;
+    }
+    return nullptr;
+}
+
+// 청크별 CRC32C 준비
+void MobileServer::loadChunkCrcs(const std::string& path, std::shared_ptr<FileHandle> file, uint64_t size, int64_t mtime,
+    boost::asio::any_io_executor executor, std::function<void(std::shared_ptr<const std::vector<uint32_t>>)> handler) {
+
+    std::shared_ptr<const std::vector<uint32_t>> cached = findChunkCrcs(path, size, mtime);
+    if (cached) {
+        boost::asio::post(executor, [handler, cached]() {
+            handler(cached);
+            });
+        return;
+    }
+
+    // 처음 보내는 파일은 블로킹 풀에서 한 번 읽어서 계산 (이후에는 sendfile 만 사용)
+    boost::asio::post(blocking_pool_, [this, path, file, size, mtime, executor, handler]() {
+
+        std::shared_ptr<const std::vector<uint32_t>> crcs = computeChunkCrcs(file->fd, size);
+        if (crcs) {
+            std::lock_guard<std::mutex> lock(crc_cache_mutex_);
+            CrcCacheEntry& entry = crc_cache_[path];
+            entry.size = size;
+            entry.mtime = mtime;
+            entry.crcs = crcs;
+        }
+
+        boost::asio::post(executor, [handler, crcs]() {
+            handler(crcs);
+            });
+        });
+}
+
+// 파일 전체를 읽어 청크별 CRC32C 계산
+std::shared_ptr<const std::vector<uint32_t>> MobileServer::computeChunkCrcs(int fd, uint64_t size) {
+
+    std::shared_ptr<std::vector<uint32_t>> crcs = std::make_shared<std::vector<uint32_t>>();
+    std::vector<char> buffer(BINARY_CHUNK_SIZE);
+    for (uint64_t offset = 0; offset < size; offset += BINARY_CHUNK_SIZE) {
+
+        size_t length = static_cast<size_t>(std::min<uint64_t>(BINARY_CHUNK_SIZE, size - offset));
+        ssize_t n = ::pread(fd, buffer.data(), length, static_cast<off_t>(offset));
+        if (n != static_cast<ssize_t>(length)) {
+            return nullptr;
+        }
+        crcs->push_back(Crc32c::update(0, buffer.data(), length));
+    }
+    return crcs;
+}
+
+// 통계
+void MobileServer::addTransferredBytes(uint64_t bytes) {
+    total_transferred_ += bytes;
+}
+
+void MobileServer::sessionOpened() {
+    active_connections_++;
+}
+
+void MobileServer::sessionClosed() {
+    active_connections_--;
+}
+
+// 주기적으로 통계 출력
+void MobileServer::monitorStats() {
+
+    uint64_t last_transferred = 0;
+    for (;;) {
+
+        std::this_thread::sleep_for(std::chrono::seconds(10));
+
+        uint64_t transferred = total_transferred_;
+        std::cout << "활성 연결: " << active_connections_ << ", 총 전송량: " << transferred << " 바이트, "
+            << "최근 10초: " << (transferred - last_transferred) / 10 / 1024 << " KB/s" << std::endl;
+        last_transferred = transferred;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "ShmChannel.h"
+#include <boost/asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct FileHandle;
+
+// io_context 를 코어마다 하나씩 두고 SO_REUSEPORT 로 accept 를 나누는 서버
+// 공유 메모리 이름을 주면 같은 컴퓨터의 클라이언트 연결("shm://이름")도 받아 스레드에 돌아가며 배정
+class MobileServer {
+public:
+    MobileServer(unsigned short port, size_t threads, const std::string& files_dir, uint64_t rate_limit = 0, const std::string& uploads_dir = "./uploads", const std::string& shm_name = "");
+
+    // 서버 실행 (종료될 때까지 반환하지 않음)
+    void run();
+
+    // 파일 폴더
+    const std::string& getFilesDirectory() const;
+
+    // 업로드 받은 파일을 저장할 폴더
+    const std::string& getUploadsDirectory() const;
+
+    // 연결당 파일 전송 속도 제한 (바이트/초, 0 이면 제한 없음)
+    uint64_t getRateLimit() const;
+
+    // 캐시된 청크별 CRC32C (BINARY_CHUNK_SIZE 단위, 아직 계산하지 않았으면 nullptr)
+    std::shared_ptr<const std::vector<uint32_t>> findChunkCrcs(const std::string& path, uint64_t size, int64_t mtime);
+
+    // 청크별 CRC32C 준비 (캐시에 없으면 블로킹 풀에서 파일을 읽어 계산하고, handler 는 executor 에서 호출, 실패하면 nullptr)
+    void loadChunkCrcs(const std::string& path, std::shared_ptr<FileHandle> file, uint64_t size, int64_t mtime,
+        boost::asio::any_io_executor executor, std::function<void(std::shared_ptr<const std::vector<uint32_t>>)> handler);
+
+    // 통계
+    void addTransferredBytes(uint64_t bytes);
+    void sessionOpened();
+    void sessionClosed();
+
+    static const size_t BINARY_CHUNK_SIZE = 256 * 1024; // 바이너리 청크 크기 (sendfile 단위)
+    static const uint64_t MAX_FILE_SIZE = 100 * 1024 * 1024; // 최대 파일 크기
+
+private:
+    // 스레드마다 하나씩: io_context 와 같은 포트를 공유하는 acceptor
+    struct Worker {
+        boost::asio::io_context io_context;
+        boost::asio::ip::tcp::acceptor acceptor;
+        Worker() : acceptor(io_context) {}
+    };
+
+    // CRC 캐시 항목
+    struct CrcCacheEntry {
+        uint64_t size;
+        int64_t mtime;
+        std::shared_ptr<const std::vector<uint32_t>> crcs;
+    };
+
+    // 연결 수락
+    void startAccept(Worker& worker);
+
+    // 공유 메모리 연결 수락 (전용 스레드)
+    void acceptShm();
+
+    // 주기적으로 통계 출력
+    void monitorStats();
+
+    // 파일 전체를 읽어 청크별 CRC32C 계산 (블로킹 풀에서 호출)
+    static std::shared_ptr<const std::vector<uint32_t>> computeChunkCrcs(int fd, uint64_t size);
+
+    unsigned short port_;
+    std::string files_dir_;
+    std::string uploads_dir_;
+    uint64_t rate_limit_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::string shm_name_;
+    std::unique_ptr<ShmListener> shm_listener_; // 공유 메모리 이름을 준 경우에만 생성
+    std::mutex crc_cache_mutex_;
+    std::map<std::string, CrcCacheEntry> crc_cache_;
+    boost::asio::thread_pool blocking_pool_; // 파일 전체를 읽는 작업 (io_context 스레드를 막지 않도록)
+    std::atomic<int64_t> active_connections_;
+    std::atomic<uint64_t> total_transferred_;
+
+    static const int SHM_ACCEPT_WAIT_MS = 1000; // 공유 메모리 연결 요청 대기 단위
+    static const size_t BLOCKING_THREADS = 2; // 블로킹 풀 스레드 수
+};
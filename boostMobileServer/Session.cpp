@@ -0,0 +1,1127 @@
+#include "Session.h"
+#include "MobileServer.h"
+#include "ControlMessage.h"
+#include "Crc32c.h"
+#include <algorithm>
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+namespace {
+
+    std::atomic<uint32_t> shm_sessions(0); // 공유 메모리 연결 번호 (로그용)
+
+    // Base64 인코딩
+    std::string base64Encode(const char* data, size_t size) {
+
+        static const char base64_chars[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "abcdefghijklmnopqrstuvwxyz"
+            "0123456789+/";
+
+        std::string encoded;
+        encoded.reserve((size + 2) / 3 * 4);
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        size_t i = 0;
+        for (; i + 2 < size; i += 3) {
+            uint32_t value = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
+            encoded.push_back(base64_chars[(value >> 18) & 0x3F]);
+            encoded.push_back(base64_chars[(value >> 12) & 0x3F]);
+            encoded.push_back(base64_chars[(value >> 6) & 0x3F]);
+            encoded.push_back(base64_chars[value & 0x3F]);
+        }
+
+        if (i < size) {
+            uint32_t value = bytes[i] << 16;
+            if (i + 1 < size) {
+                value |= bytes[i + 1] << 8;
+            }
+            encoded.push_back(base64_chars[(value >> 18) & 0x3F]);
+            encoded.push_back(base64_chars[(value >> 12) & 0x3F]);
+            encoded.push_back(i + 1 < size ? base64_chars[(value >> 6) & 0x3F] : '=');
+            encoded.push_back('=');
+        }
+
+        return encoded;
+    }
+
+    // 파일 일부를 dest 로 읽기
+    bool readInto(int fd, uint64_t offset, char* dest, size_t length) {
+
+        size_t done = 0;
+        while (done < length) {
+            ssize_t n = ::pread(fd, dest + done, length - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // 파일 일부 읽기
+    bool readAt(int fd, uint64_t offset, size_t length, std::vector<char>& buffer) {
+
+        buffer.resize(length);
+        return readInto(fd, offset, buffer.data(), length);
+    }
+}
+
+// 파일 닫기
+FileHandle::~FileHandle() {
+    ::close(fd);
+}
+
+// 생성자
+Session::Session(boost::asio::ip::tcp::socket socket, MobileServer& server) : socket_(std::move(socket)),
+    server_(server),
+    read_header_(0),
+    read_flags_(0),
+    max_transfers_(1),
+    last_transfer_id_(0),
+    writing_(false),
+    pace_timer_(socket_.get_executor()),
+    pacing_(false),
+    compression_(false),
+    binary_chunks_(false),
+    binary_control_(false),
+    network_quality_(1.0),
+    closed_(false) {
+
+    boost::system::error_code ec;
+    auto endpoint = socket_.remote_endpoint(ec);
+    id_ = ec ? "unknown" : endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+
+    server_.sessionOpened();
+}
+
+// 생성자 (공유 메모리 연결)
+Session::Session(std::shared_ptr<ShmChannel> channel, boost::asio::io_context& io_context, MobileServer& server) : socket_(io_context),
+    shm_channel_(channel),
+    server_(server),
+    id_("shm#" + std::to_string(++shm_sessions)),
+    read_header_(0),
+    read_flags_(0),
+    max_transfers_(1),
+    last_transfer_id_(0),
+    writing_(false),
+    pace_timer_(io_context),
+    pacing_(false),
+    compression_(false),
+    binary_chunks_(false),
+    binary_control_(false),
+    network_quality_(1.0),
+    closed_(false) {
+
+    server_.sessionOpened();
+}
+
+// 소멸자
+Session::~Session() {
+    server_.sessionClosed();
+    std::cout << "클라이언트 연결 종료: " << id_ << std::endl;
+}
+
+// 수신 시작
+void Session::start() {
+
+    std::cout << "클라이언트 연결: " << id_ << std::endl;
+
+    // sendfile 이 EAGAIN 을 돌려주도록 논블로킹으로 설정
+    if (!shm_channel_) {
+        boost::system::error_code ec;
+        socket_.native_non_blocking(true, ec);
+    }
+
+    doReadHeader();
+}
+
+// 소켓 또는 공유 메모리로 읽기
+template <typename MutableBuffers, typename Handler>
+void Session::asyncRead(const MutableBuffers& buffers, Handler&& handler) {
+
+    if (shm_channel_) {
+        std::vector<boost::asio::mutable_buffer> sequence(boost::asio::buffer_sequence_begin(buffers), boost::asio::buffer_sequence_end(buffers));
+        shm_channel_->asyncRead(sequence, ShmChannel::Handler(std::forward<Handler>(handler)));
+    }
+    else {
+        boost::asio::async_read(socket_, buffers, std::forward<Handler>(handler));
+    }
+}
+
+// 소켓 또는 공유 메모리로 쓰기
+template <typename ConstBuffers, typename Handler>
+void Session::asyncWrite(const ConstBuffers& buffers, Handler&& handler) {
+
+    if (shm_channel_) {
+        std::vector<boost::asio::const_buffer> sequence(boost::asio::buffer_sequence_begin(buffers), boost::asio::buffer_sequence_end(buffers));
+        shm_channel_->asyncWrite(sequence, ShmChannel::Handler(std::forward<Handler>(handler)));
+    }
+    else {
+        boost::asio::async_write(socket_, buffers, std::forward<Handler>(handler));
+    }
+}
+
+// 프레임 헤더 수신
+void Session::doReadHeader() {
+
+    auto self(shared_from_this());
+    asyncRead(boost::asio::buffer(&read_header_, sizeof(uint32_t)),
+        [this, self](boost::system::error_code ec, std::size_t) {
+
+            if (ec) {
+                close();
+                return;
+            }
+
+            size_t length;
+            FrameCodec::decodeHeader(read_header_, length, read_flags_);
+            if (length > FrameCodec::MAX_MESSAGE_SIZE) {
+                std::cerr << "잘못된 프레임: " << id_ << std::endl;
+                close();
+                return;
+            }
+
+            read_buffer_.resize(length);
+            doReadBody();
+        });
+}
+
+// 프레임 본문 수신
+void Session::doReadBody() {
+
+    auto self(shared_from_this());
+    asyncRead(boost::asio::buffer(read_buffer_),
+        [this, self](boost::system::error_code ec, std::size_t) {
+
+            if (ec) {
+                close();
+                return;
+            }
+
+            if (read_flags_ & FrameCodec::CONTROL_FLAG) {
+                handleControl(read_buffer_.data(), read_buffer_.size());
+                doReadHeader();
+                return;
+            }
+
+            if (read_flags_ & FrameCodec::BINARY_CHUNK_FLAG) {
+                handleUploadChunk(read_buffer_.data(), read_buffer_.size());
+                doReadHeader();
+                return;
+            }
+
+            const std::vector<char>* payload = &read_buffer_;
+            if (read_flags_ & FrameCodec::COMPRESSED_FLAG) {
+                if (!FrameCodec::decompress(read_buffer_.data(), read_buffer_.size(), decompress_buffer_)) {
+                    std::cerr << "압축 해제 실패: " << id_ << std::endl;
+                    close();
+                    return;
+                }
+                payload = &decompress_buffer_;
+            }
+
+            Json::Value message;
+            Json::Reader reader;
+            if (reader.parse(payload->data(), payload->data() + payload->size(), message)) {
+                handleMessage(message);
+            }
+            else {
+                std::cerr << "유효하지 않은 메시지 형식: " << id_ << std::endl;
+            }
+
+            doReadHeader();
+        });
+}
+
+// 수신한 메시지 처리
+void Session::handleMessage(const Json::Value& message) {
+
+    std::string type = message["type"].asString();
+    const Json::Value& content = message["content"];
+
+    if (type == "heartbeat") {
+
+        queueHeartbeatAck();
+    }
+    else if (type == "hello") {
+
+        handleHello(content);
+    }
+    else if (type == "chat") {
+
+        std::cout << id_ << "로부터 메시지 받음: " << content.asString() << std::endl;
+    }
+    else if (type == "network_quality") {
+
+        double quality = content.asDouble();
+        if (quality > 0) {
+            network_quality_ = quality;
+        }
+    }
+    else if (type == "filerequest") {
+
+        queueAllFiles();
+    }
+    else if (type == "resume") {
+
+        queueResume(content);
+    }
+    else if (type == "range_request") {
+
+        queueRange(content);
+    }
+    else if (type == "stripe_request") {
+
+        queueStripe(content);
+    }
+    else if (type == "file_cancel") {
+
+        cancelTransfer(content["transfer_id"].asUInt());
+    }
+    else if (type == "upload_start") {
+
+        startUpload(content);
+    }
+    else if (type == "upload_end") {
+
+        finishUpload(content);
+    }
+    else if (type == "upload_cancel") {
+
+        cancelUpload(content["transfer_id"].asUInt());
+    }
+    else {
+
+        std::cout << "알 수 없는 메시지 타입: " << type << std::endl;
+    }
+}
+
+// 바이너리 제어 메시지 처리 (필드는 수신 버퍼에서 바로 읽음)
+void Session::handleControl(const char* data, size_t size) {
+
+    ControlView view;
+    if (!view.parse(data, size)) {
+        std::cerr << "잘못된 제어 메시지: " << id_ << std::endl;
+        return;
+    }
+
+    switch (view.type()) {
+
+    case ControlType::Heartbeat:
+        queueHeartbeatAck();
+        break;
+
+    case ControlType::NetworkQuality: {
+        double quality = view.get<ControlSchema::NetworkQuality::Quality>();
+        if (quality > 0) {
+            network_quality_ = quality;
+        }
+        break;
+    }
+
+    default:
+        std::cout << "알 수 없는 제어 메시지: " << static_cast<int>(view.type()) << std::endl;
+        break;
+    }
+}
+
+// 하트비트 응답
+void Session::queueHeartbeatAck() {
+
+    OutgoingFrame frame;
+    if (binary_control_) {
+        ControlMessage::encodeHeartbeatAck(frame.body);
+        makeControlFrame(frame);
+    }
+    else {
+        Json::Value ack;
+        ack["type"] = "heartbeat_ack";
+        makeMessageFrame(ack, frame);
+    }
+
+    control_queue_.push_back(std::move(frame));
+    doWrite();
+}
+
+// 기능 협상
+void Session::handleHello(const Json::Value& content) {
+
+    bool lz4 = false;
+    for (const Json::Value& codec : content["compression"]) {
+        if (codec.asString() == "lz4") {
+            lz4 = true;
+        }
+    }
+
+#ifdef __linux__
+    bool binary = content["binary_chunks"].asBool();
+#else
+    bool binary = false;
+#endif
+
+    // 구간 요청은 TCP 연결을 여러 개 열어야 하므로 공유 메모리 연결에서는 지원하지 않음
+    // 여러 파일의 청크를 섞어 받을 수 있는 클라이언트만 동시 전송
+    size_t transfers = content.get("max_transfers", 1).asUInt();
+    max_transfers_ = std::max<size_t>(1, std::min(transfers, MAX_TRANSFERS));
+
+    Json::Value ack;
+    ack["type"] = "hello_ack";
+    ack["content"]["compression"] = lz4 ? "lz4" : "";
+    ack["content"]["binary_chunks"] = binary;
+    ack["content"]["max_transfers"] = static_cast<Json::UInt>(max_transfers_);
+    ack["content"]["stripes"] = !shm_channel_;
+    ack["content"]["uploads"] = true;
+    ack["content"]["binary_control"] = content["binary_control"].asBool();
+
+    // 응답은 압축하지 않은 JSON 으로 보낸 뒤 적용
+    queueMessage(ack);
+    compression_ = lz4;
+    binary_chunks_ = binary;
+    binary_control_ = content["binary_control"].asBool();
+
+    std::cout << "클라이언트 " << id_ << " 압축: " << (lz4 ? "lz4" : "없음") << ", 바이너리 청크: " << (binary ? "사용" : "사용 안 함") << ", 동시 전송: " << max_transfers_ << std::endl;
+}
+
+// 제어 메시지 전송
+void Session::queueMessage(const Json::Value& message) {
+
+    OutgoingFrame frame;
+    makeMessageFrame(message, frame);
+    control_queue_.push_back(std::move(frame));
+    doWrite();
+}
+
+// JSON 메시지를 프레임으로 변환
+void Session::makeMessageFrame(const Json::Value& message, OutgoingFrame& frame) const {
+
+    Json::FastWriter writer;
+    frame.body = writer.write(message);
+    frame.file.reset();
+    frame.file_offset = 0;
+    frame.file_length = 0;
+
+    uint32_t flags = 0;
+    std::string compressed;
+    if (compression_ && frame.body.size() >= FrameCodec::MIN_COMPRESS_SIZE && FrameCodec::compress(frame.body.data(), frame.body.size(), compressed)) {
+        frame.body.swap(compressed);
+        flags = FrameCodec::COMPRESSED_FLAG;
+    }
+
+    frame.header = FrameCodec::encodeHeader(frame.body.size(), flags);
+}
+
+// 본문에 인코딩된 바이너리 제어 메시지를 프레임으로 완성
+void Session::makeControlFrame(OutgoingFrame& frame) const {
+
+    frame.file.reset();
+    frame.file_offset = 0;
+    frame.file_length = 0;
+    frame.header = FrameCodec::encodeHeader(frame.body.size(), FrameCodec::CONTROL_FLAG);
+}
+
+// 업로드 시작
+void Session::startUpload(const Json::Value& content) {
+
+    uint32_t transferId = content["transfer_id"].asUInt();
+    std::string fileName = content["filename"].asString();
+    uint64_t fileSize = content["filesize"].asUInt64();
+
+    // 경로가 포함된 이름은 허용하지 않음
+    boost::filesystem::path name = boost::filesystem::path(fileName).filename();
+    if (name.empty() || name == "." || name == ".." || name.string() != fileName || fileSize > MobileServer::MAX_FILE_SIZE || uploads_.count(transferId)) {
+        std::cerr << "업로드 거부: " << id_ << " " << fileName << std::endl;
+        queueUploadAck(transferId, fileName, false);
+        return;
+    }
+
+    // 같은 이름을 동시에 올리는 연결이 있어도 겹치지 않는 임시 파일
+    Upload upload;
+    upload.name = fileName;
+    upload.part_path = (boost::filesystem::path(server_.getUploadsDirectory()) / boost::filesystem::unique_path(fileName + ".%%%%-%%%%.part")).string();
+    upload.size = fileSize;
+    upload.received = 0;
+    upload.crc = 0;
+    upload.failed = false;
+
+    int fd = ::open(upload.part_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "업로드 파일 생성 오류: " << upload.part_path << std::endl;
+        queueUploadAck(transferId, fileName, false);
+        return;
+    }
+    upload.file = std::make_shared<FileHandle>(fd);
+
+    std::cout << id_ << " 업로드 시작: " << fileName << " (" << fileSize << " 바이트)" << std::endl;
+    uploads_[transferId] = std::move(upload);
+}
+
+// 업로드 청크 기록
+void Session::handleUploadChunk(const char* data, size_t size) {
+
+    BinaryChunkHeader header;
+    if (!FrameCodec::decodeBinaryChunkHeader(data, size, header)) {
+        std::cerr << "잘못된 업로드 청크: " << id_ << std::endl;
+        return;
+    }
+
+    auto it = uploads_.find(header.transfer_id);
+    if (it == uploads_.end() || it->second.failed) {
+        return;
+    }
+
+    Upload& upload = it->second;
+    const char* chunk = data + FrameCodec::BINARY_CHUNK_HEADER_SIZE;
+    size_t length = size - FrameCodec::BINARY_CHUNK_HEADER_SIZE;
+
+    // 클라이언트는 순서대로 보내므로 받은 끝에 이어지는 청크만 허용
+    if (header.offset != upload.received || length > upload.size - upload.received || Crc32c::update(0, chunk, length) != header.crc) {
+        std::cerr << "업로드 청크 오류: " << upload.name << " (" << header.offset << ")" << std::endl;
+        upload.failed = true;
+        return;
+    }
+
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = ::pwrite(upload.file->fd, chunk + done, length - done, static_cast<off_t>(header.offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            std::cerr << "업로드 쓰기 오류: " << upload.part_path << std::endl;
+            upload.failed = true;
+            return;
+        }
+        done += static_cast<size_t>(n);
+    }
+
+    upload.received += length;
+    upload.crc = Crc32c::combine(upload.crc, header.crc, length);
+}
+
+// 업로드 완료 (크기와 전체 CRC32C 가 맞으면 저장)
+void Session::finishUpload(const Json::Value& content) {
+
+    uint32_t transferId = content["transfer_id"].asUInt();
+    auto it = uploads_.find(transferId);
+    if (it == uploads_.end()) {
+        return;
+    }
+
+    Upload& upload = it->second;
+    bool saved = !upload.failed && upload.received == upload.size && upload.crc == content["crc"].asUInt();
+    upload.file.reset();
+
+    if (saved) {
+        boost::system::error_code ec;
+        boost::filesystem::rename(upload.part_path, boost::filesystem::path(server_.getUploadsDirectory()) / upload.name, ec);
+        saved = !ec;
+    }
+
+    if (saved) {
+        std::cout << id_ << " 업로드 저장: " << upload.name << " (" << upload.size << " 바이트)" << std::endl;
+    }
+    else {
+        std::cerr << id_ << " 업로드 실패: " << upload.name << " (" << upload.received << "/" << upload.size << ")" << std::endl;
+        discardUpload(upload);
+    }
+
+    queueUploadAck(transferId, upload.name, saved);
+    uploads_.erase(it);
+}
+
+// 업로드 결과 알림
+void Session::queueUploadAck(uint32_t transferId, const std::string& fileName, bool saved) {
+
+    Json::Value ack;
+    ack["type"] = "upload_ack";
+    ack["content"]["transfer_id"] = transferId;
+    ack["content"]["filename"] = fileName;
+    ack["content"]["saved"] = saved;
+    queueMessage(ack);
+}
+
+// 업로드 취소
+void Session::cancelUpload(uint32_t transferId) {
+
+    auto it = uploads_.find(transferId);
+    if (it == uploads_.end()) {
+        return;
+    }
+
+    std::cout << id_ << " 업로드 취소: " << it->second.name << std::endl;
+    discardUpload(it->second);
+    uploads_.erase(it);
+}
+
+// 임시 파일 삭제
+void Session::discardUpload(Upload& upload) {
+
+    upload.file.reset();
+    ::unlink(upload.part_path.c_str());
+}
+
+// 파일 열기
+bool Session::openJob(const std::string& fileName, FileJob& job) const {
+
+    // 경로가 포함된 이름은 허용하지 않음
+    boost::filesystem::path name = boost::filesystem::path(fileName).filename();
+    if (name.empty() || name == "." || name == ".." || name.string() != fileName) {
+        std::cerr << "잘못된 파일 이름: " << fileName << std::endl;
+        return false;
+    }
+
+    job.transfer_id = 0;
+    job.name = fileName;
+    job.path = (boost::filesystem::path(server_.getFilesDirectory()) / name).string();
+
+    int fd = ::open(job.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "파일 열기 오류: " << job.path << std::endl;
+        return false;
+    }
+    job.file = std::make_shared<FileHandle>(fd);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+
+    job.size = static_cast<uint64_t>(st.st_size);
+    job.mtime = static_cast<int64_t>(st.st_mtime);
+    job.start = 0;
+    job.next = 0;
+    job.end = job.size;
+    job.crc = 0;
+    job.send_start = true;
+    job.send_end = true;
+    job.stripe = false;
+
+    if (job.size > MobileServer::MAX_FILE_SIZE) {
+        std::cerr << "파일 크기 초과: " << job.path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// files 폴더의 모든 파일 전송
+void Session::queueAllFiles() {
+
+    std::cout << "클라이언트 " << id_ << "로부터 파일 요청 받음" << std::endl;
+
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator it(server_.getFilesDirectory(), ec), end; !ec && it != end; it.increment(ec)) {
+
+        if (!boost::filesystem::is_regular_file(it->status())) {
+            continue;
+        }
+
+        FileJob job;
+        if (openJob(it->path().filename().string(), job)) {
+            job.transfer_id = ++last_transfer_id_;
+            queueJob(std::move(job), 0, 0);
+        }
+    }
+
+    if (ec) {
+        std::cerr << "파일 디렉토리 읽기 오류: " << ec.message() << std::endl;
+    }
+}
+
+// 이어받기
+void Session::queueResume(const Json::Value& content) {
+
+    FileJob job;
+    if (!openJob(content["filename"].asString(), job)) {
+        return;
+    }
+
+    job.transfer_id = ++last_transfer_id_;
+    queueJob(std::move(job), content["offset"].asUInt64(), content["crc"].asUInt());
+}
+
+// 청크 CRC 가 준비되면 전송 작업 추가 (이어받기면 resume_offset 까지의 CRC 를 확인하고 그 위치부터)
+void Session::queueJob(FileJob job, uint64_t resume_offset, uint32_t resume_crc) {
+
+    auto self(shared_from_this());
+    auto pending = std::make_shared<FileJob>(std::move(job));
+    pending_jobs_.insert(pending->transfer_id);
+    server_.loadChunkCrcs(pending->path, pending->file, pending->size, pending->mtime, pace_timer_.get_executor(),
+        [this, self, pending, resume_offset, resume_crc](std::shared_ptr<const std::vector<uint32_t>> crcs) {
+
+            if (closed_) {
+                return;
+            }
+
+            // CRC 를 읽는 동안 취소된 전송은 버림
+            auto it = pending_jobs_.find(pending->transfer_id);
+            if (it == pending_jobs_.end()) {
+                return;
+            }
+            pending_jobs_.erase(it);
+
+            FileJob& job = *pending;
+            if (resume_offset > 0) {
+
+                uint32_t prefix_crc = 0;
+                if (crcs && resume_offset <= job.size && prefixCrc(job, *crcs, resume_offset, prefix_crc) && prefix_crc == resume_crc) {
+                    job.next = resume_offset;
+                    job.crc = resume_crc;
+                }
+                else {
+                    std::cout << "이어받기 위치 불일치, 처음부터 전송: " << job.name << std::endl;
+                }
+            }
+
+            file_jobs_.push_back(std::move(job));
+            doWrite();
+        });
+}
+
+// 파일 앞부분의 CRC32C (캐시된 청크 CRC 를 합치고, 청크 중간에서 끝나면 마지막 조각만 읽음)
+bool Session::prefixCrc(const FileJob& job, const std::vector<uint32_t>& crcs, uint64_t length, uint32_t& crc) {
+
+    size_t chunks = static_cast<size_t>(length / MobileServer::BINARY_CHUNK_SIZE);
+    if (chunks > crcs.size()) {
+        return false;
+    }
+
+    crc = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        crc = Crc32c::combine(crc, crcs[i], MobileServer::BINARY_CHUNK_SIZE);
+    }
+
+    uint64_t tail_offset = static_cast<uint64_t>(chunks) * MobileServer::BINARY_CHUNK_SIZE;
+    size_t tail = static_cast<size_t>(length - tail_offset);
+    if (tail > 0) {
+        std::vector<char> buffer;
+        if (!readAt(job.file->fd, tail_offset, tail, buffer)) {
+            return false;
+        }
+        crc = Crc32c::update(crc, buffer.data(), tail);
+    }
+    return true;
+}
+
+// 손상된 구간 재전송 (진행 중인 파일보다 먼저, 항상 JSON 청크)
+void Session::queueRange(const Json::Value& content) {
+
+    FileJob job;
+    if (!openJob(content["filename"].asString(), job)) {
+        return;
+    }
+
+    uint64_t offset = content["offset"].asUInt64();
+    uint64_t length = content["length"].asUInt64();
+    if (length == 0 || length > MAX_CHUNK_SIZE || offset >= job.size) {
+        std::cerr << "잘못된 구간 요청: " << job.name << std::endl;
+        return;
+    }
+
+    // 클라이언트가 받고 있는 전송 ID 로 보냄
+    job.transfer_id = content["transfer_id"].asUInt();
+    job.next = offset;
+    job.end = std::min<uint64_t>(offset + length, job.size);
+    job.send_start = false;
+    job.send_end = false;
+
+    active_jobs_.push_front(std::move(job));
+    doWrite();
+}
+
+// 구간 전송 (한 파일을 여러 연결로 나눠 받는 클라이언트용, 끝나면 구간 CRC 를 stripe_end 로 알림)
+void Session::queueStripe(const Json::Value& content) {
+
+    FileJob job;
+    if (!openJob(content["filename"].asString(), job)) {
+        return;
+    }
+
+    uint64_t offset = content["offset"].asUInt64();
+    uint64_t length = content["length"].asUInt64();
+    if (length == 0 || offset >= job.size) {
+        std::cerr << "잘못된 구간 요청: " << job.name << std::endl;
+        return;
+    }
+
+    job.transfer_id = content["transfer_id"].asUInt();
+    job.start = offset;
+    job.next = offset;
+    job.end = std::min<uint64_t>(offset + length, job.size);
+    job.send_start = false;
+    job.stripe = true;
+
+    queueJob(std::move(job), 0, 0);
+}
+
+// 파일 전송 취소
+void Session::cancelTransfer(uint32_t transferId) {
+
+    auto cancelled = [transferId](const FileJob& job) {
+        return job.transfer_id == transferId;
+    };
+    file_jobs_.erase(std::remove_if(file_jobs_.begin(), file_jobs_.end(), cancelled), file_jobs_.end());
+    active_jobs_.erase(std::remove_if(active_jobs_.begin(), active_jobs_.end(), cancelled), active_jobs_.end());
+    pending_jobs_.erase(transferId);
+
+    std::cout << "클라이언트 " << id_ << " 전송 취소: " << transferId << std::endl;
+}
+
+// 진행 중인 파일 작업을 돌아가며 다음 프레임 만들기
+bool Session::nextFileFrame(OutgoingFrame& frame) {
+
+    while (true) {
+
+        // 동시 전송 수만큼 대기 중인 파일 시작
+        while (active_jobs_.size() < max_transfers_ && !file_jobs_.empty()) {
+            active_jobs_.push_back(std::move(file_jobs_.front()));
+            file_jobs_.pop_front();
+        }
+
+        if (active_jobs_.empty()) {
+            return false;
+        }
+
+        // 파일마다 한 프레임씩 번갈아 보내서 작은 파일이 큰 파일 뒤에서 기다리지 않도록
+        FileJob job = std::move(active_jobs_.front());
+        active_jobs_.pop_front();
+
+        bool finished = false;
+        bool produced = makeJobFrame(job, frame, finished);
+        if (!finished) {
+            active_jobs_.push_back(std::move(job));
+        }
+
+        if (produced) {
+            return true;
+        }
+    }
+}
+
+// 파일 작업 하나에서 다음 프레임 만들기
+bool Session::makeJobFrame(FileJob& job, OutgoingFrame& frame, bool& finished) {
+
+    if (job.send_start) {
+
+        if (binary_control_) {
+            ControlMessage::encodeFileStart(job.transfer_id, job.name, job.size, job.next, frame.body);
+            makeControlFrame(frame);
+        }
+        else {
+            Json::Value message;
+            message["type"] = "file_start";
+            message["content"]["transfer_id"] = job.transfer_id;
+            message["content"]["filename"] = job.name;
+            message["content"]["filesize"] = static_cast<Json::UInt64>(job.size);
+            message["content"]["offset"] = static_cast<Json::UInt64>(job.next);
+            makeMessageFrame(message, frame);
+        }
+
+        job.send_start = false;
+        std::cout << "클라이언트 " << id_ << "에게 파일 전송 시작: " << job.name << " (offset " << job.next << ")" << std::endl;
+        return true;
+    }
+
+    if (job.next < job.end) {
+
+        // 구간 재전송은 파일 이름이 있는 JSON 청크로 보냄
+        bool binary = binary_chunks_ && job.send_end;
+
+        size_t length;
+        if (binary) {
+            // 캐시된 청크 경계에 맞춤 (이어받기 첫 청크만 짧아짐)
+            length = MobileServer::BINARY_CHUNK_SIZE - static_cast<size_t>(job.next % MobileServer::BINARY_CHUNK_SIZE);
+        }
+        else {
+            length = jsonChunkSize();
+        }
+        length = static_cast<size_t>(std::min<uint64_t>(length, job.end - job.next));
+
+        uint32_t crc;
+        if (binary) {
+
+            crc = chunkCrc(job, job.next, length);
+
+            BinaryChunkHeader header;
+            header.transfer_id = job.transfer_id;
+            header.offset = job.next;
+            header.crc = crc;
+
+            frame.body.resize(FrameCodec::BINARY_CHUNK_HEADER_SIZE);
+            FrameCodec::encodeBinaryChunkHeader(header, &frame.body[0]);
+            frame.header = FrameCodec::encodeHeader(FrameCodec::BINARY_CHUNK_HEADER_SIZE + length, FrameCodec::BINARY_CHUNK_FLAG);
+            frame.file = job.file;
+            frame.file_offset = job.next;
+            frame.file_length = length;
+        }
+        else {
+
+            std::vector<char> buffer;
+            if (!readAt(job.file->fd, job.next, length, buffer)) {
+                std::cerr << "파일 읽기 오류: " << job.path << std::endl;
+                finished = true;
+                return false;
+            }
+
+            crc = Crc32c::update(0, buffer.data(), length);
+
+            Json::Value message;
+            message["type"] = "file_chunk";
+            message["content"]["transfer_id"] = job.transfer_id;
+            message["content"]["filename"] = job.name;
+            message["content"]["offset"] = static_cast<Json::UInt64>(job.next);
+            message["content"]["crc"] = crc;
+            message["content"]["data"] = base64Encode(buffer.data(), length);
+            makeMessageFrame(message, frame);
+        }
+
+        job.crc = Crc32c::combine(job.crc, crc, length);
+        job.next += length;
+        return true;
+    }
+
+    finished = true;
+
+    if (job.send_end && job.stripe) {
+
+        Json::Value message;
+        message["type"] = "stripe_end";
+        message["content"]["transfer_id"] = job.transfer_id;
+        message["content"]["filename"] = job.name;
+        message["content"]["offset"] = static_cast<Json::UInt64>(job.start);
+        message["content"]["length"] = static_cast<Json::UInt64>(job.end - job.start);
+        message["content"]["crc"] = job.crc;
+        makeMessageFrame(message, frame);
+        return true;
+    }
+
+    if (job.send_end) {
+
+        if (binary_control_) {
+            ControlMessage::encodeFileEnd(job.transfer_id, job.name, job.crc, true, frame.body);
+            makeControlFrame(frame);
+        }
+        else {
+            Json::Value message;
+            message["type"] = "file_end";
+            message["content"]["transfer_id"] = job.transfer_id;
+            message["content"]["filename"] = job.name;
+            message["content"]["crc"] = job.crc;
+            makeMessageFrame(message, frame);
+        }
+
+        std::cout << "클라이언트 " << id_ << "에게 파일 전송 완료: " << job.name << std::endl;
+        return true;
+    }
+
+    return false;
+}
+
+// 청크 CRC32C
+uint32_t Session::chunkCrc(const FileJob& job, uint64_t offset, size_t length) {
+
+    // 청크 경계에 맞으면 캐시 사용
+    if (offset % MobileServer::BINARY_CHUNK_SIZE == 0 && (length == MobileServer::BINARY_CHUNK_SIZE || offset + length == job.size)) {
+
+        auto crcs = server_.findChunkCrcs(job.path, job.size, job.mtime);
+        size_t index = static_cast<size_t>(offset / MobileServer::BINARY_CHUNK_SIZE);
+        if (crcs && index < crcs->size()) {
+            return (*crcs)[index];
+        }
+    }
+
+    std::vector<char> buffer;
+    if (!readAt(job.file->fd, offset, length, buffer)) {
+        return 0;
+    }
+    return Crc32c::update(0, buffer.data(), length);
+}
+
+// 네트워크 품질에 따른 JSON 청크 크기
+size_t Session::jsonChunkSize() const {
+
+    size_t chunk_size = static_cast<size_t>(DEFAULT_CHUNK_SIZE * network_quality_);
+    return std::max(MIN_CHUNK_SIZE, std::min(MAX_CHUNK_SIZE, chunk_size));
+}
+
+// 프레임 전송 (제어 메시지 우선, 그다음 파일 청크)
+void Session::doWrite() {
+
+    if (writing_ || closed_) {
+        return;
+    }
+
+    if (!control_queue_.empty()) {
+        current_ = std::move(control_queue_.front());
+        control_queue_.pop_front();
+    }
+    else {
+
+        // 연결당 전송 속도 제한: 보낸 만큼 다음 파일 프레임을 늦춤
+        uint64_t rate_limit = server_.getRateLimit();
+        if (rate_limit > 0 && std::chrono::steady_clock::now() < next_send_time_) {
+
+            if (!pacing_) {
+                pacing_ = true;
+                auto self(shared_from_this());
+                pace_timer_.expires_at(next_send_time_);
+                pace_timer_.async_wait([this, self](boost::system::error_code) {
+                    pacing_ = false;
+                    doWrite();
+                    });
+            }
+            return;
+        }
+
+        if (!nextFileFrame(current_)) {
+            return;
+        }
+
+        if (rate_limit > 0) {
+            uint64_t frame_size = sizeof(uint32_t) + current_.body.size() + current_.file_length;
+            next_send_time_ = std::max(next_send_time_, std::chrono::steady_clock::now()) + std::chrono::microseconds(frame_size * 1000000 / rate_limit);
+        }
+    }
+
+    writing_ = true;
+
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(&current_.header, sizeof(uint32_t)));
+    buffers.push_back(boost::asio::buffer(current_.body));
+
+    auto self(shared_from_this());
+    asyncWrite(buffers,
+        [this, self](boost::system::error_code ec, std::size_t bytes_transferred) {
+
+            if (ec) {
+                close();
+                return;
+            }
+
+            server_.addTransferredBytes(bytes_transferred);
+
+            if (current_.file) {
+                sendFileBody();
+            }
+            else {
+                onWriteComplete();
+            }
+        });
+}
+
+// 바이너리 청크 본문을 sendfile 로 전송 (사용자 공간 복사 없음)
+// 공유 메모리 연결이면 파일을 링에 바로 읽어 넣음 (중간 버퍼 없음)
+void Session::sendFileBody() {
+
+    if (shm_channel_) {
+
+        std::shared_ptr<FileHandle> file = current_.file;
+        uint64_t offset = current_.file_offset;
+
+        auto self(shared_from_this());
+        shm_channel_->asyncWriteFrom(current_.file_length,
+            [file, offset](char* dest, size_t length, size_t position) {
+                return readInto(file->fd, offset + position, dest, length);
+            },
+            [this, self](boost::system::error_code ec, std::size_t bytes_transferred) {
+
+                if (ec) {
+                    std::cerr << "파일 전송 오류: " << id_ << std::endl;
+                    close();
+                    return;
+                }
+
+                server_.addTransferredBytes(bytes_transferred);
+                onWriteComplete();
+            });
+        return;
+    }
+
+#ifdef __linux__
+    while (current_.file_length > 0) {
+
+        off_t offset = static_cast<off_t>(current_.file_offset);
+        ssize_t n = ::sendfile(socket_.native_handle(), current_.file->fd, &offset, current_.file_length);
+
+        if (n > 0) {
+            current_.file_offset += static_cast<uint64_t>(n);
+            current_.file_length -= static_cast<size_t>(n);
+            server_.addTransferredBytes(static_cast<uint64_t>(n));
+            continue;
+        }
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        // 소켓 버퍼가 가득 차면 쓸 수 있을 때까지 대기
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+
+            auto self(shared_from_this());
+            socket_.async_wait(boost::asio::ip::tcp::socket::wait_write, [this, self](boost::system::error_code ec) {
+                if (ec) {
+                    close();
+                    return;
+                }
+                sendFileBody();
+                });
+            return;
+        }
+
+        std::cerr << "sendfile 오류: " << id_ << std::endl;
+        close();
+        return;
+    }
+#endif
+
+    onWriteComplete();
+}
+
+// 프레임 하나 전송 완료
+void Session::onWriteComplete() {
+
+    writing_ = false;
+    current_.file.reset();
+    current_.body.clear();
+    doWrite();
+}
+
+// 연결 종료
+void Session::close() {
+
+    if (closed_) {
+        return;
+    }
+
+    closed_ = true;
+    pace_timer_.cancel();
+    file_jobs_.clear();
+    active_jobs_.clear();
+    control_queue_.clear();
+
+    // 끝나지 않은 업로드는 버림 (클라이언트가 다시 시작)
+    for (auto& upload : uploads_) {
+        discardUpload(upload.second);
+    }
+    uploads_.clear();
+
+    if (shm_channel_) {
+        shm_channel_->close();
+        return;
+    }
+
+    boost::system::error_code ec;
+    socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+    socket_.close(ec);
+}
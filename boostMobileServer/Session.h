@@ -0,0 +1,185 @@
+#pragma once
+#include "FrameCodec.h"
+#include "ShmChannel.h"
+#include <boost/asio.hpp>
+#include <json/json.h>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class MobileServer;
+
+// 열린 파일 (마지막 사용자가 닫음)
+struct FileHandle {
+    int fd;
+    explicit FileHandle(int descriptor) : fd(descriptor) {}
+    ~FileHandle();
+};
+
+// 클라이언트 연결 하나 (한 io_context 스레드에서만 실행되므로 잠금 없음)
+class Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(boost::asio::ip::tcp::socket socket, MobileServer& server);
+
+    // 공유 메모리 연결 (io_context 는 채널을 만든 스레드의 것)
+    Session(std::shared_ptr<ShmChannel> channel, boost::asio::io_context& io_context, MobileServer& server);
+    ~Session();
+
+    // 수신 시작
+    void start();
+
+private:
+    // 파일 전송 작업
+    struct FileJob {
+        uint32_t transfer_id; // 전송 ID (file_start/file_chunk/file_end 와 바이너리 청크 헤더에 실림)
+        std::string name; // 파일 이름
+        std::string path; // 파일 경로
+        std::shared_ptr<FileHandle> file;
+        uint64_t size; // 파일 크기
+        int64_t mtime; // 수정 시간 (CRC 캐시 확인용)
+        uint64_t start; // 보낼 시작 위치
+        uint64_t next; // 다음에 보낼 위치
+        uint64_t end; // 보낼 끝 위치
+        uint32_t crc; // next 까지의 CRC32C
+        bool send_start; // file_start 를 보내야 하는지
+        bool send_end; // file_end 를 보내야 하는지
+        bool stripe; // 구간 요청이면 file_end 대신 stripe_end
+    };
+
+    // 받는 중인 업로드
+    struct Upload {
+        std::string name; // 파일 이름
+        std::string part_path; // 받는 중인 임시 파일 경로
+        std::shared_ptr<FileHandle> file;
+        uint64_t size; // 파일 크기
+        uint64_t received; // 앞에서부터 받은 크기
+        uint32_t crc; // received 까지의 CRC32C
+        bool failed; // 청크 CRC 불일치, 순서 어긋남, 쓰기 실패
+    };
+
+    // 전송할 프레임
+    struct OutgoingFrame {
+        uint32_t header; // 길이 + 플래그 (big endian)
+        std::string body; // 프레임 본문 (바이너리 청크면 청크 헤더만)
+        std::shared_ptr<FileHandle> file; // 바이너리 청크면 sendfile 로 보낼 파일
+        uint64_t file_offset;
+        size_t file_length;
+    };
+
+    // 소켓 또는 공유 메모리로 읽기/쓰기
+    template <typename MutableBuffers, typename Handler>
+    void asyncRead(const MutableBuffers& buffers, Handler&& handler);
+
+    template <typename ConstBuffers, typename Handler>
+    void asyncWrite(const ConstBuffers& buffers, Handler&& handler);
+
+    // 프레임 수신
+    void doReadHeader();
+    void doReadBody();
+
+    // 수신한 메시지 처리
+    void handleMessage(const Json::Value& message);
+
+    // 바이너리 제어 메시지 처리
+    void handleControl(const char* data, size_t size);
+
+    // 기능 협상 (압축, 바이너리 청크, 바이너리 제어 메시지)
+    void handleHello(const Json::Value& content);
+
+    // 하트비트 응답 (협상 결과에 따라 바이너리 또는 JSON)
+    void queueHeartbeatAck();
+
+    // 제어 메시지 전송 (파일 청크보다 먼저 보냄)
+    void queueMessage(const Json::Value& message);
+
+    // JSON 메시지를 프레임으로 변환
+    void makeMessageFrame(const Json::Value& message, OutgoingFrame& frame) const;
+
+    // 본문에 인코딩된 바이너리 제어 메시지를 프레임으로 완성
+    void makeControlFrame(OutgoingFrame& frame) const;
+
+    // 파일 전송 작업 추가
+    void queueAllFiles();
+    void queueResume(const Json::Value& content);
+    void queueRange(const Json::Value& content);
+    void queueStripe(const Json::Value& content);
+
+    // 청크 CRC 를 블로킹 풀에서 준비한 뒤 전송 작업 추가 (resume_offset 이 0 이 아니면 그 앞부분의 CRC 확인)
+    void queueJob(FileJob job, uint64_t resume_offset, uint32_t resume_crc);
+
+    // 파일 앞부분의 CRC32C (캐시된 청크 CRC 를 Crc32c::combine 으로 합침)
+    static bool prefixCrc(const FileJob& job, const std::vector<uint32_t>& crcs, uint64_t length, uint32_t& crc);
+
+    // 파일 전송 취소 (아직 보내지 않은 청크)
+    void cancelTransfer(uint32_t transferId);
+
+    // 업로드 받기 (upload_start, 바이너리 청크, upload_end, upload_cancel)
+    void startUpload(const Json::Value& content);
+    void handleUploadChunk(const char* data, size_t size);
+    void finishUpload(const Json::Value& content);
+    void cancelUpload(uint32_t transferId);
+
+    // 업로드 결과 알림 (upload_ack)
+    void queueUploadAck(uint32_t transferId, const std::string& fileName, bool saved);
+
+    // 임시 파일 삭제
+    static void discardUpload(Upload& upload);
+
+    // 파일 열기 (files 폴더 밖은 허용하지 않음)
+    bool openJob(const std::string& fileName, FileJob& job) const;
+
+    // 진행 중인 파일 작업을 돌아가며 다음 프레임 만들기
+    bool nextFileFrame(OutgoingFrame& frame);
+
+    // 파일 작업 하나에서 다음 프레임 만들기 (작업이 끝나면 finished)
+    bool makeJobFrame(FileJob& job, OutgoingFrame& frame, bool& finished);
+
+    // 청크 CRC32C (queueJob 에서 준비한 캐시에 있으면 파일을 읽지 않음)
+    uint32_t chunkCrc(const FileJob& job, uint64_t offset, size_t length);
+
+    // 네트워크 품질에 따른 JSON 청크 크기
+    size_t jsonChunkSize() const;
+
+    // 프레임 전송
+    void doWrite();
+    void sendFileBody();
+    void onWriteComplete();
+
+    // 연결 종료
+    void close();
+
+    boost::asio::ip::tcp::socket socket_;
+    std::shared_ptr<ShmChannel> shm_channel_; // 공유 메모리 연결이면 socket_ 대신 사용
+    MobileServer& server_;
+    std::string id_;
+    uint32_t read_header_;
+    uint32_t read_flags_;
+    std::vector<char> read_buffer_;
+    std::vector<char> decompress_buffer_;
+    std::deque<OutgoingFrame> control_queue_;
+    std::deque<FileJob> file_jobs_; // 시작을 기다리는 파일
+    std::deque<FileJob> active_jobs_; // 청크를 번갈아 보내는 중인 파일
+    std::multiset<uint32_t> pending_jobs_; // 청크 CRC 를 읽는 중이라 아직 큐에 들어가지 않은 전송 id (구간 전송은 같은 id 가 여러 번 올 수 있음)
+    std::map<uint32_t, Upload> uploads_; // 받는 중인 업로드 (클라이언트가 정한 업로드 ID -> 상태)
+    size_t max_transfers_; // 동시에 보낼 파일 수 (hello 로 협상)
+    uint32_t last_transfer_id_;
+    OutgoingFrame current_;
+    bool writing_;
+    boost::asio::steady_timer pace_timer_; // 전송 속도 제한 대기
+    std::chrono::steady_clock::time_point next_send_time_; // 다음 파일 프레임을 보낼 수 있는 시각
+    bool pacing_;
+    bool compression_;
+    bool binary_chunks_;
+    bool binary_control_; // file_start, file_end, 하트비트를 바이너리 형식으로 주고받는지
+    double network_quality_;
+    bool closed_;
+
+    static const size_t DEFAULT_CHUNK_SIZE = 16 * 1024;
+    static const size_t MIN_CHUNK_SIZE = 4 * 1024;
+    static const size_t MAX_CHUNK_SIZE = 64 * 1024;
+    static const size_t MAX_TRANSFERS = 16; // 클라이언트가 더 많이 요청해도 이 수까지만
+};
@@ -0,0 +1,34 @@
+#include "MobileServer.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// 사용법: boostMobileServer [포트=51111] [스레드 수=코어 수] [파일 폴더=./files] [연결당 전송 제한 KB/s=0(제한 없음)] [업로드 폴더=./uploads] [공유 메모리 이름=없음]
+int main(int argc, char* argv[]) {
+
+    unsigned short port = argc > 1 ? static_cast<unsigned short>(std::atoi(argv[1])) : 51111;
+    size_t threads = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+    std::string files_dir = argc > 3 ? argv[3] : "./files";
+    uint64_t rate_limit = argc > 4 ? std::strtoull(argv[4], nullptr, 10) * 1024 : 0;
+    std::string uploads_dir = argc > 5 ? argv[5] : "./uploads";
+    std::string shm_name = argc > 6 ? argv[6] : "";
+
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // 끊긴 소켓에 sendfile 할 때 프로세스가 종료되지 않도록
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        MobileServer server(port, threads, files_dir, rate_limit, uploads_dir, shm_name);
+        server.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "네트워크 오류: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}